@@ -0,0 +1 @@
+#include <AVLAugmentation.h>
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+
+/*
+ *	Augmentations for AVLTree. Every node keeps a Summary of its whole subtree, recomputed by
+ *	update() from the node's data and the summaries of its two children (nullptr for a missing
+ *	child) whenever the subtree changes: in the rotations and on the path from an inserted or
+ *	removed node up to the root. That is O(log n) extra work per insertion/removal and lets the
+ *	tree answer select(k), rank(x), count(lo, hi) and aggregate(lo, hi) in O(log n).
+ */
+
+// Default: nothing is stored in the nodes and nothing is recomputed
+struct AVLNoAugmentation
+{
+	static constexpr bool HAS_SUMMARY = false;
+	static constexpr bool HAS_SIZE = false;
+
+	struct Summary
+	{
+	};
+
+	template <typename T>
+	static void update(Summary &, const T &, const Summary *, const Summary *)
+	{
+	}
+};
+
+// Subtree sizes, needed by select(k), rank(x) and count(lo, hi)
+struct AVLOrderStatistics
+{
+	static constexpr bool HAS_SUMMARY = true;
+	static constexpr bool HAS_SIZE = true;
+
+	struct Summary
+	{
+		size_t size = 0;
+	};
+
+	template <typename T>
+	static void update(Summary &summary, const T &, const Summary *left, const Summary *right)
+	{
+		summary.size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+	}
+};
+
+/*
+ *	Subtree sizes plus the aggregate of a user defined monoid, needed by aggregate(lo, hi).
+ *	Monoid has to provide
+ *		using Value = ...;
+ *		static Value identity();
+ *		static Value fromData(const T &data);
+ *		static Value combine(const Value &lhs, const Value &rhs);	// associative
+ *	lhs always covers the smaller keys, so combine does not have to be commutative.
+ */
+template <typename Monoid>
+struct AVLRangeAggregate
+{
+	using MonoidType = Monoid;
+	using Value = typename Monoid::Value;
+
+	static constexpr bool HAS_SUMMARY = true;
+	static constexpr bool HAS_SIZE = true;
+
+	struct Summary
+	{
+		size_t size = 0;
+		Value value = Monoid::identity();
+	};
+
+	template <typename T>
+	static void update(Summary &summary, const T &data, const Summary *left, const Summary *right)
+	{
+		summary.size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+
+		Value value = Monoid::fromData(data);
+		if (left != nullptr)
+		{
+			value = Monoid::combine(left->value, value);
+		}
+		if (right != nullptr)
+		{
+			value = Monoid::combine(value, right->value);
+		}
+		summary.value = value;
+	}
+};
+
+// Sum of the elements, e.g. AVLTree<int, std::less<>, std::allocator<int>, AVLRangeAggregate<SumMonoid<long long>>>
+template <typename V>
+struct SumMonoid
+{
+	using Value = V;
+
+	static Value identity()
+	{
+		return Value();
+	}
+
+	template <typename T>
+	static Value fromData(const T &data)
+	{
+		return static_cast<Value>(data);
+	}
+
+	static Value combine(const Value &lhs, const Value &rhs)
+	{
+		return lhs + rhs;
+	}
+};
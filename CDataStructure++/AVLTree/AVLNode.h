@@ -1,8 +1,13 @@
 #pragma once
 #include <cstddef>
 #include <iostream>
+#include "AVLAugmentation.h"
 
-template <typename T>
+/*
+ *	Node of an AVLTree. Besides the balance factor it keeps the Summary of the Augmentation for
+ *	its subtree (empty for the default AVLNoAugmentation), see AVLAugmentation.h.
+ */
+template <typename T, typename Augmentation = AVLNoAugmentation>
 class AVLNode
 {
 public:
@@ -14,6 +19,7 @@ public:
 		  parent(nullptr),
 		  bf(0) // each node inserted starts off with balance factor of 0 since it is a leaf node (no left or right trees available yet)
 	{
+		updateSummary();
 	}
 
 	explicit AVLNode(
@@ -25,6 +31,7 @@ public:
 		  left(nullptr),
 		  right(nullptr)
 	{
+		updateSummary();
 	}
 
 	// ~AVLNode()
@@ -119,6 +126,17 @@ public:
 		return parent;
 	}
 
+	inline const typename Augmentation::Summary &getSummary() const
+	{
+		return summary;
+	}
+
+	// Recompute the summary of this subtree, the summaries of both children must be up to date
+	inline void updateSummary()
+	{
+		Augmentation::update(summary, data, left ? &left->summary : nullptr, right ? &right->summary : nullptr);
+	}
+
 	inline void printNode()
 	{
 		std::cout << "\n";
@@ -155,4 +173,5 @@ private:
 	AVLNode *right;	 // pointer to right node
 	AVLNode *parent; // pointer to parent node
 	signed char bf;	 // balance factor of current node
+	typename Augmentation::Summary summary; // augmentation of the subtree rooted here
 };
\ No newline at end of file
@@ -1,38 +1,217 @@
 #pragma once
 #include <AVLNode.h>
 #include <BinarySearchTree.h>
+#include <SortedBuild.h>
+#include <algorithm>
 #include <cstddef>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
-
-template <typename T>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "../Allocator/PoolAllocator.h"
+
+/*
+ *	Self balancing binary search tree ordered by Compare. With a transparent Compare (the default
+ *	std::less<> is one) searchNode accepts any key comparable to T without building a temporary T.
+ *	begin/end and range(lo, hi) iterate in order by following the parent pointers.
+ *	build_from_sorted loads sorted input in O(n) without any rotation.
+ *	join, split and join2 cut and glue whole trees in O(log n), and unionWith, intersectionWith and
+ *	differenceWith built on them combine two trees in parallel without copying a node.
+ *	Nodes are allocated with Allocator (rebound to AVLNode<T, Augmentation>), e.g. a PoolAllocator.
+ *	With AVLOrderStatistics or AVLRangeAggregate as Augmentation (see AVLAugmentation.h) every node
+ *	also knows the size (and aggregate) of its subtree, which makes select, rank, count and
+ *	aggregate O(log n) instead of a walk over the whole tree.
+ */
+template <typename T, typename Compare = std::less<>, typename Allocator = std::allocator<T>, typename Augmentation = AVLNoAugmentation>
 class AVLTree
 {
 public:
-	// typedef pair containing the deleted root and whether it was deleted from the right direction
-	using _AVL_fromRight_Pair = std::pair<AVLNode<T> *, bool>;
+	using NodeType = AVLNode<T, Augmentation>;
+
+private:
+	// T itself, or any key type if Compare is transparent
+	template <typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, T>::value || IsTransparentCompare<Compare>::value>::type;
+
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<NodeType>;
+	using NodeAllocatorTraits = std::allocator_traits<NodeAllocator>;
+
+public:
+	// typedef pair containing the node whose subtree lost a level by a removal and whether it lost it on the right side
+	using _AVL_fromRight_Pair = std::pair<NodeType *, bool>;
+
+public:
+	/*
+	 *	Bidirectional in-order iterator. It steps along the parent pointers of the nodes, so it
+	 *	needs no stack and never allocates; ++ and -- are amortized O(1). end() is the null node,
+	 *	-- on it goes to the largest value, which is why the iterator also knows its tree.
+	 *	Every node reached prefetches the child subtree visited after it, so on a tree whose nodes
+	 *	are scattered in memory that miss overlaps with the work on the current value.
+	 *	Values are the keys of the tree, so they are read-only (same as std::set).
+	 */
+	class Iterator
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T *;
+		using reference = const T &;
+
+	public:
+		Iterator()
+			: node(nullptr),
+			  tree(nullptr)
+		{
+		}
+
+		Iterator(NodeType *node, const AVLTree *tree)
+			: node(node),
+			  tree(tree)
+		{
+		}
+
+		reference operator*() const
+		{
+			return node->getData();
+		}
+
+		pointer operator->() const
+		{
+			return &node->getData();
+		}
+
+		Iterator &operator++()
+		{
+			if (node->hasRight())
+			{
+				node = leftmost(node->getRight());
+			}
+			else
+			{
+				// climb until coming up from a left child, that parent is next
+				NodeType *childNode = node;
+				node = node->getParent();
+				while (node != nullptr && node->getRight() == childNode)
+				{
+					childNode = node;
+					node = node->getParent();
+				}
+				if (node != nullptr)
+				{
+					prefetch(node->getRight());
+				}
+			}
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		Iterator &operator--()
+		{
+			if (node == nullptr)
+			{
+				node = rightmost(tree->root);
+			}
+			else if (node->hasLeft())
+			{
+				node = rightmost(node->getLeft());
+			}
+			else
+			{
+				// climb until coming up from a right child, that parent is previous
+				NodeType *childNode = node;
+				node = node->getParent();
+				while (node != nullptr && node->getLeft() == childNode)
+				{
+					childNode = node;
+					node = node->getParent();
+				}
+				if (node != nullptr)
+				{
+					prefetch(node->getLeft());
+				}
+			}
+			return *this;
+		}
+
+		Iterator operator--(int)
+		{
+			Iterator previous = *this;
+			--*this;
+			return previous;
+		}
+
+		// the node the iterator points to, nullptr for end()
+		NodeType *getNode() const
+		{
+			return node;
+		}
+
+		friend bool operator==(const Iterator &lhs, const Iterator &rhs)
+		{
+			return lhs.node == rhs.node;
+		}
+
+		friend bool operator!=(const Iterator &lhs, const Iterator &rhs)
+		{
+			return lhs.node != rhs.node;
+		}
+
+	private:
+		NodeType *node;
+		const AVLTree *tree;
+	};
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
 
 public:
-	AVLTree()
-		: root(nullptr)
+	explicit AVLTree(const Allocator &allocator = Allocator())
+		: root(nullptr),
+		  nodeAllocator(allocator)
 	{
 	}
 
-	AVLTree(const T &data)
-		: root(new AVLNode<T>(data))
+	AVLTree(const T &data, const Allocator &allocator = Allocator())
+		: root(nullptr),
+		  nodeAllocator(allocator)
 	{
+		root = createNode(data);
 	}
 
 	// Delete constructors which may cause headache and bugs
-	AVLTree(const AVLTree<T> &) = delete;
-	AVLTree(AVLTree<T> &&) = delete;
+	AVLTree(const AVLTree &) = delete;
+	AVLTree(AVLTree &&) = delete;
 
 	~AVLTree()
 	{
-		cleanUpTree(root);
+		// with a pool of its own the slabs are freed wholesale, no need to visit every node
+		if (!poolFreesInBulk<NodeType>(nodeAllocator))
+		{
+			cleanUpTree(root);
+		}
+		releaseNodeBlocks();
 	}
 
-	void printTree(AVLNode<T> *node = nullptr)
+	void printTree(NodeType *node = nullptr)
 	{
 		std::cout << "Printing the AVL Tree\n";
 		std::cout << "|-- = left node (value < parent value)\n";
@@ -48,193 +227,78 @@ public:
 		}
 	}
 
-	// Should be the same way as with deletion in BST.
-	// Regarding balance factor and flow of updates:
-	// 	1: The BF of successor node should be replaced with the BF of the removed node
-	//	2: After deletion, the parent before deletion of the node that is used to replace the deleted
-	//		node should be used to recursivly update BF values of parent nodes until BF of -1 or 1 is found
+	/*
+	 *	Unlinks and frees the node with the given data from the subtree of currNode, without rebalancing.
+	 *	Returns the node whose subtree lost one level and whether it lost it on the right side, which is
+	 *	where rebalancing (and updating summaries) has to start; nullptr if nothing was removed or the
+	 *	root was replaced by its only child.
+	 *	There are 2 options for deletion:
+	 *		1: currNode has at most one child -> the child (or nullptr) takes the place of currNode
+	 *		2: currNode has both children -> the inorder successor (which has no left child) is unlinked,
+	 *			its right child taking its place, and the successor takes the place and the bf of currNode
+	 */
 	_AVL_fromRight_Pair removeNode(
 		const T &data,
-		AVLNode<T> *currNode)
+		NodeType *currNode)
 	{
-		if (currNode == nullptr)
+		while (currNode != nullptr)
 		{
-			return std::make_pair(nullptr, false);
+			if (comp(data, currNode->getData()))
+			{
+				currNode = currNode->getLeft();
+			}
+			else if (comp(currNode->getData(), data))
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				break;
+			}
 		}
 
-		if (data < currNode->getData())
+		if (currNode == nullptr)
 		{
-			return removeNode(data, currNode->getLeft());
+			return std::make_pair(nullptr, false);
 		}
-		else if (data > currNode->getData())
+
+		if (!currNode->hasLeft() || !currNode->hasRight())
 		{
-			return removeNode(data, currNode->getRight());
+			NodeType *parentNode = currNode->getParent();
+			NodeType *childNode = currNode->hasLeft() ? currNode->getLeft() : currNode->getRight();
+			const bool isRightNode = parentNode != nullptr && isRightChild(parentNode, currNode);
+			replaceInParent(currNode, childNode);
+			destroyNode(currNode);
+			return std::make_pair(parentNode, isRightNode);
 		}
-		else
-		{
-			// Current node contains the given data.
-			// There are 4 options for deletion:
-			//	1: currNode has no children -> let the parent point to nullptr and then delete the currNode
-			//	2: currNode has only left child -> make left child the new currNode and delete the old currNode
-			//	3: currNode has only right child -> make the parent left/right ref point to right child the currNode and delete the old currNode
-			//	4: currNode has both children:
-			//		4.1: if the direct right node of currNode does not have a left child, then:
-			//			4.1.1: make the right node the new currNode
-			//			4.1.2: make the child of new currNode the left child of old currNode
-			//			4.1.3: make parent node point to new currNode
-			//			4.1.4: delete old currNode
-			//		4.2: if the direct right node of currNode does have a left child, then search for inorder successor node by traversing to the deepest left node
-			//		4.3: make successor the new root of the tree
-			//			4.3.1: if successor has right child, make the left child of parent of the successor point to that child
-
-			// TODO: this if statement is only done to change root pointer which is not possible
-			// by changing the currNode pointer. See if somehow reference of pointer can be passed instead
-			// to change the copy of the pointer outside of the function to point somewhere else.
-			if (currNode->getParent() == nullptr) // root contains the value we need to remove
-			{
-				if (!currNode->hasLeft() && !currNode->hasRight())
-				{
-					delete root;
-					root = nullptr;
-					return std::make_pair(root, false);
-				}
-				else if (!currNode->hasRight() && currNode->hasLeft())
-				{
-					AVLNode<T> *leftOfCurrNode = currNode->getLeft(); // get left child of root
-					leftOfCurrNode->setParent(nullptr);				  // set parent of left child to nullptr
-					leftOfCurrNode->setBf(root->getBf());			  // set bf to value of root
-					root = leftOfCurrNode;							  // assign root to left child
-					delete currNode;								  // delete previous root
-					currNode = nullptr;
-					return std::make_pair(root, false); // return pair with root and fromRight bool
-				}
-				else if (currNode->hasRight() && !currNode->hasLeft())
-				{
-					AVLNode<T> *rightOfCurrNode = currNode->getRight(); // get right child of root
-					rightOfCurrNode->setParent(nullptr);				// set parent of right child to nullptr
-					rightOfCurrNode->setBf(root->getBf());				// set bf to value of root
-					root = rightOfCurrNode;								// assign root to right child
-					delete currNode;									// delete previous root
-					currNode = nullptr;
-					return std::make_pair(root, true); // return pair with root and fromRight bool
-				}
-				else
-				{
-					AVLNode<T> *inorderSuccessorNode = findInorderSuccessor(currNode->getRight());
-					AVLNode<T> *parentInorderSuccessorNode = inorderSuccessorNode->getParent();
 
-					// successor node is the direct right node from the root
-					if (inorderSuccessorNode == currNode->getRight())
-					{
-						inorderSuccessorNode->setLeft(root->getLeft()); // set left of successor to left subtree of root
-						inorderSuccessorNode->setParent(nullptr);		// parent is now nullptr since successor is new root
-						inorderSuccessorNode->setBf(root->getBf());		// bf value should be same as root node
-						root = inorderSuccessorNode;					// assign root to inorder successor
-						delete currNode;								// delete previous root
-						currNode = nullptr;
-						return std::make_pair(root, true); // return pair with inorder successor and fromRight bool
-					}
-					else // successor node is somewhere in the tree
-					{
-						AVLNode<T> *rightOfSuccessorNode = inorderSuccessorNode->getRight();
-						parentInorderSuccessorNode->setLeft(rightOfSuccessorNode); // set left of parent successor to right of successor
-						// if successor has right node, then make parent of right node the parent of successor
-						if (rightOfSuccessorNode != nullptr)
-						{
-							rightOfSuccessorNode->setParent(parentInorderSuccessorNode);
-						}
-						// Set the parent of the successor node parent to the successor itself as it replaces the old root
-						// which, if the parent of successor node is not updated, will be deleted and parent will point to nullptr
-						if (parentInorderSuccessorNode->getParent() == root)
-						{
-							parentInorderSuccessorNode->setParent(inorderSuccessorNode);
-						}
-						inorderSuccessorNode->setLeft(root->getLeft());	  // set left subtree of prev. root to new root
-						inorderSuccessorNode->setRight(root->getRight()); // set right subtree of prev. root to new root
-						inorderSuccessorNode->setParent(nullptr);		  // set parent of inorder successor to nullptr since it is now the root
-						inorderSuccessorNode->setBf(root->getBf());		  // bf value should be same as root node
-						root = inorderSuccessorNode;					  // set inorder successor as the new root
-						delete currNode;								  // delete previous root
-						currNode = nullptr;
-						return std::make_pair(parentInorderSuccessorNode, false); // return parent of successor with fromRight false since it is always the left child
-					}
-				}
-			}
-			else
-			{
-				AVLNode<T> *parentNode = currNode->getParent();
+		NodeType *inorderSuccessorNode = findInorderSuccessor(currNode->getRight());
 
-				if (!currNode->hasLeft() && !currNode->hasRight())
-				{
-					const auto isRightNode = isRightChild(parentNode, currNode); // make sure correct fromRight value is given as it can be right/left depending on parent ref
-					setChildFromParent(parentNode, currNode, nullptr);			 // set parent node approperaite child to nullptr as it is deleted
-					delete currNode;											 // delete the node that needs to be deleted
-					currNode = nullptr;
-					return std::make_pair(parentNode, isRightNode); // return parent node for rebalancing, fromRight bool does not matter
-				}
-				else if (!currNode->hasRight() && currNode->hasLeft())
-				{
-					AVLNode<T> *leftCurrNode = currNode->getLeft();
-					leftCurrNode->setParent(parentNode);					// change parent of left child to parent of currNode
-					leftCurrNode->setBf(currNode->getBf());					// set bf of left child to bf of currNode
-					setChildFromParent(parentNode, currNode, leftCurrNode); // update parent ref to point to the new child
-					delete currNode;										// delete currNode
-					currNode = nullptr;
-					return std::make_pair(leftCurrNode, false); // return new child of the parent for rebalancing with fromRight false
-				}
-				else if (currNode->hasRight() && !currNode->hasLeft())
-				{
-					AVLNode<T> *rightCurrNode = currNode->getRight();
-					rightCurrNode->setParent(parentNode);					 // change parent of right child to parent of currNode
-					rightCurrNode->setBf(currNode->getBf());				 // set bf of right child to bf of currNode
-					setChildFromParent(parentNode, currNode, rightCurrNode); // update parent ref to point to the new child
-					delete currNode;										 // delete currNode
-					currNode = nullptr;
-					return std::make_pair(rightCurrNode, true); // return new child of the parent for rebalancing with fromRight is true
-				}
-				else
-				{
-					AVLNode<T> *inorderSuccessorNode = findInorderSuccessor(currNode->getRight());
-					AVLNode<T> *parentInorderSuccessorNode = inorderSuccessorNode->getParent();
+		// successor node is the direct right node: it keeps its right subtree, which is one level lower now
+		_AVL_fromRight_Pair loweredNode = std::make_pair(inorderSuccessorNode, true);
 
-					// successor node is the direct right node from the root
-					if (inorderSuccessorNode == currNode->getRight())
-					{
-						inorderSuccessorNode->setLeft(currNode->getLeft()); // set left of successor to left subtree of currNode
-						inorderSuccessorNode->setParent(parentNode);		// parent is now parentNode
-						inorderSuccessorNode->setBf(currNode->getBf());		// bf value should be same as currNode
-						setChildFromParent(parentNode, currNode, inorderSuccessorNode);
-						delete currNode; // delete currNode
-						currNode = nullptr;
-						return std::make_pair(inorderSuccessorNode, true); // return pair with inorder successor and fromRight bool
-					}
-					else // successor node is somewhere in the tree
-					{
-						AVLNode<T> *rightOfSuccessorNode = inorderSuccessorNode->getRight();
-						parentInorderSuccessorNode->setLeft(rightOfSuccessorNode); // set left of parent successor to right of successor
-						// if successor has right node, then make parent of right node the parent of successor
-						if (rightOfSuccessorNode != nullptr)
-						{
-							rightOfSuccessorNode->setParent(parentInorderSuccessorNode);
-						}
-						// Set the parent of the successor node parent to the successor itself as it replaces the currNode
-						// which, if the parent of successor node is not updated, will be deleted and parent will point to nullptr
-						if (parentInorderSuccessorNode->getParent() == currNode)
-						{
-							parentInorderSuccessorNode->setParent(inorderSuccessorNode);
-						}
-						inorderSuccessorNode->setLeft(currNode->getLeft());				// set left subtree of prev. root to new root
-						inorderSuccessorNode->setRight(currNode->getRight());			// set right subtree of prev. root to new root
-						inorderSuccessorNode->setParent(parentNode);					// set parent of inorder successor to parentNode
-						inorderSuccessorNode->setBf(currNode->getBf());					// bf value should be same as inorder successor
-						setChildFromParent(parentNode, currNode, inorderSuccessorNode); // set inorder successor as the new root
-						delete currNode;												// delete previous root
-						currNode = nullptr;
-						return std::make_pair(parentInorderSuccessorNode, false); // return parent of successor with fromRight false since it is always the left child
-					}
-				}
+		// successor node is somewhere in the tree: it is the left child of its parent, its right child moves up
+		if (inorderSuccessorNode != currNode->getRight())
+		{
+			NodeType *parentInorderSuccessorNode = inorderSuccessorNode->getParent();
+			NodeType *rightOfSuccessorNode = inorderSuccessorNode->getRight();
+			parentInorderSuccessorNode->setLeft(rightOfSuccessorNode);
+			if (rightOfSuccessorNode != nullptr)
+			{
+				rightOfSuccessorNode->setParent(parentInorderSuccessorNode);
 			}
+
+			inorderSuccessorNode->setRight(currNode->getRight());
+			currNode->getRight()->setParent(inorderSuccessorNode);
+			loweredNode = std::make_pair(parentInorderSuccessorNode, false);
 		}
+
+		inorderSuccessorNode->setLeft(currNode->getLeft());
+		currNode->getLeft()->setParent(inorderSuccessorNode);
+		inorderSuccessorNode->setBf(currNode->getBf());
+		replaceInParent(currNode, inorderSuccessorNode);
+		destroyNode(currNode);
+		return loweredNode;
 	}
 
 	/*
@@ -247,17 +311,20 @@ public:
 		auto isDeletedFromRightTree = retValue.second;
 
 		if (parentRemovedNodeRef)
+		{
 			rebalanceTreeDeletion(parentRemovedNodeRef, isDeletedFromRightTree);
+			updateSummariesToRoot(parentRemovedNodeRef);
+		}
 	}
 
 	/*
 	 * SIMPLE ROTATION - LEFT CASE:
 	 *	Z (currNode) is a left child of its parent X (parentNode) and BF(Z) <= 0
 	 */
-	AVLNode<T> *rotateLeft(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	NodeType *rotateLeft(NodeType *parentNode, NodeType *currNode)
 	{
 		// currNode is by 2 higher than its sibling
-		AVLNode<T> *innerChild = currNode->getLeft(); // Left child of currNode
+		NodeType *innerChild = currNode->getLeft(); // Left child of currNode
 		parentNode->setRight(innerChild);
 
 		if (innerChild != nullptr)
@@ -289,6 +356,10 @@ public:
 			currNode->setBf(0);
 		}
 
+		// parentNode is a child of currNode now, so it is updated first
+		parentNode->updateSummary();
+		currNode->updateSummary();
+
 		return currNode; // return new root of rotated subtree
 	}
 
@@ -296,10 +367,10 @@ public:
 	 * SIMPLE ROTATION - RIGHT CASE:
 	 *	Z (currNode) is a right child of its parent X (parentNode) and BF(Z) >= 0
 	 */
-	AVLNode<T> *rotateRight(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	NodeType *rotateRight(NodeType *parentNode, NodeType *currNode)
 	{
 		// currNode is by 2 higher than its sibling
-		AVLNode<T> *innerChild = currNode->getRight(); // Right child of currNode
+		NodeType *innerChild = currNode->getRight(); // Right child of currNode
 		parentNode->setLeft(innerChild);
 
 		if (innerChild != nullptr)
@@ -331,6 +402,10 @@ public:
 			currNode->setBf(0);
 		}
 
+		// parentNode is a child of currNode now, so it is updated first
+		parentNode->updateSummary();
+		currNode->updateSummary();
+
 		return currNode; // return new root of rotated subtree
 	}
 
@@ -338,11 +413,11 @@ public:
 	 * DOUBLE ROTATION - RIGHT_LEFT ROTATION:
 	 *	Z (currNode) is a right child of its parent X (parentNode) and BF(Z) < 0
 	 */
-	AVLNode<T> *rotateRightLeft(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	NodeType *rotateRightLeft(NodeType *parentNode, NodeType *currNode)
 	{
-		AVLNode<T> *innerChild = currNode->getLeft();			// Y
-		AVLNode<T> *leftOfInnerChild = innerChild->getLeft();	// t2
-		AVLNode<T> *rightOfInnerChild = innerChild->getRight(); // t3
+		NodeType *innerChild = currNode->getLeft();			// Y
+		NodeType *leftOfInnerChild = innerChild->getLeft();	// t2
+		NodeType *rightOfInnerChild = innerChild->getRight(); // t3
 		const auto innerChildBF = innerChild->getBf();
 
 		// if (innerChild != nullptr) // FOR DEBUGGING: it is assumed/expected that this node exists
@@ -396,6 +471,10 @@ public:
 
 		innerChild->setBf(0);
 
+		parentNode->updateSummary();
+		currNode->updateSummary();
+		innerChild->updateSummary();
+
 		return innerChild;
 		// }
 		// std::cout << "[rotateRightLeft] innerChild is not valid (nullptr): " << innerChild << "\n";
@@ -406,11 +485,11 @@ public:
 	 * DOUBLE ROTATION - LEFT_RIGHT ROTATION:
 	 *	Z (currNode) is a left child of its parent X (parentNode) and BF(Z) > 0
 	 */
-	AVLNode<T> *rotateLeftRight(AVLNode<T> *parentNode, AVLNode<T> *currNode)
+	NodeType *rotateLeftRight(NodeType *parentNode, NodeType *currNode)
 	{
-		AVLNode<T> *innerChild = currNode->getRight();			// Y
-		AVLNode<T> *leftOfInnerChild = innerChild->getLeft();	// t3
-		AVLNode<T> *rightOfInnerChild = innerChild->getRight(); // t2
+		NodeType *innerChild = currNode->getRight();			// Y
+		NodeType *leftOfInnerChild = innerChild->getLeft();	// t3
+		NodeType *rightOfInnerChild = innerChild->getRight(); // t2
 		const auto innerChildBF = innerChild->getBf();
 
 		// if (innerChild != nullptr) // FOR DEBUGGING: it is assumed/expected that this node exists
@@ -464,24 +543,28 @@ public:
 
 		innerChild->setBf(0);
 
+		parentNode->updateSummary();
+		currNode->updateSummary();
+		innerChild->updateSummary();
+
 		return innerChild;
 		// }
 		// std::cout << "[rotateLeftRight] innerChild is not valid (nullptr): " << innerChild << "\n";
 		// return nullptr;
 	}
 
-	AVLNode<T> *insertNode(
+	NodeType *insertNode(
 		const T &data,
-		AVLNode<T> *currNode)
+		NodeType *currNode)
 	{
 		if (root == nullptr)
 		{
-			root = new AVLNode<T>(data);
+			root = createNode(data);
 			return root;
 		}
 		else if (currNode != nullptr)
 		{
-			if (data < currNode->getData())
+			if (comp(data, currNode->getData()))
 			{
 				if (currNode->hasLeft())
 				{
@@ -489,11 +572,11 @@ public:
 				}
 				else
 				{
-					currNode->setLeft(new AVLNode<T>(data, currNode));
+					currNode->setLeft(createNode(data, currNode));
 					return currNode->getLeft();
 				}
 			}
-			else if (data > currNode->getData())
+			else if (comp(currNode->getData(), data))
 			{
 				if (currNode->hasRight())
 				{
@@ -501,7 +584,7 @@ public:
 				}
 				else
 				{
-					currNode->setRight(new AVLNode<T>(data, currNode));
+					currNode->setRight(createNode(data, currNode));
 					return currNode->getRight();
 				}
 			}
@@ -516,99 +599,515 @@ public:
 		const auto insertedNodeRef = insertNode(data, root);
 
 		if (insertedNodeRef)
+		{
 			rebalanceTreeInsertion(insertedNodeRef);
+			updateSummariesToRoot(insertedNodeRef);
+		}
 	}
 
-	AVLNode<T> *getRoot()
+	/*
+	 *	Replaces the contents of the tree with the values of the sorted range [first, last) in O(n)
+	 *	and without a single rotation: the nodes come from one contiguous block, laid out in sorted
+	 *	order, and are linked bottom-up into a perfectly balanced tree with its bf values, parent
+	 *	links and summaries set directly. Equal neighbours are kept once, like insertNode does.
+	 *	An unsorted range throws std::invalid_argument before the tree is touched; if copying a
+	 *	value throws, the tree is left empty.
+	 *	Removed nodes of the block are destroyed, but the block is only freed as a whole when no
+	 *	tree holds any of its nodes anymore.
+	 */
+	template <typename ForwardIt>
+	void build_from_sorted(ForwardIt first, const ForwardIt last)
 	{
-		return this->root;
+		const size_t count = tree_detail::countSortedDistinct(first, last, comp);
+		clearTree();
+		if (count == 0)
+		{
+			return;
+		}
+
+		// called once per node in sorted order, skips the equal neighbours of the value it returns
+		const auto nextValue = [&first, &last, this](size_t) -> const T & {
+			ForwardIt current = first;
+			for (++first; first != last && !comp(*current, *first); ++first)
+			{
+			}
+			return *current;
+		};
+		NodeBuilder<decltype(nextValue)> builder{*this, allocateNodeBlock(count), nextValue};
+		buildFromBlock(builder, count, 1);
 	}
 
-	AVLNode<T> *searchNode(const T &data)
+	/*
+	 *	build_from_sorted, with the left and right halves of the tree built on separate threads
+	 *	(threadCount 0 means std::thread::hardware_concurrency()). Every node is constructed
+	 *	straight from its position in [first, last), so input with equal neighbours is built by
+	 *	build_from_sorted instead, as are inputs too small to be worth starting threads for.
+	 */
+	template <typename RandomIt>
+	void parallel_build_from_sorted(RandomIt first, const RandomIt last, size_t threadCount = 0)
 	{
-		return searchNode(data, root);
+		static constexpr size_t MIN_NODES_PER_THREAD = 16384;
+
+		const size_t count = tree_detail::countSortedDistinct(first, last, comp);
+		if (count != static_cast<size_t>(last - first))
+		{
+			build_from_sorted(first, last);
+			return;
+		}
+
+		if (threadCount == 0)
+		{
+			threadCount = std::thread::hardware_concurrency();
+		}
+		if (threadCount > count / MIN_NODES_PER_THREAD)
+		{
+			threadCount = count / MIN_NODES_PER_THREAD;
+		}
+
+		clearTree();
+		if (count == 0)
+		{
+			return;
+		}
+
+		const auto valueAt = [first](const size_t index) -> const T & {
+			return first[index];
+		};
+		NodeBuilder<decltype(valueAt)> builder{*this, allocateNodeBlock(count), valueAt};
+		buildFromBlock(builder, count, threadCount);
 	}
 
-	inline AVLNode<T> *findInorderSuccessor(AVLNode<T> *rightNodeOfCurrNode)
+	/*
+	 *	Moves key and every value of right into this tree. All values of this tree have to be less
+	 *	than key and key less than all values of right, otherwise std::invalid_argument is thrown
+	 *	and nothing changes. The taller tree takes the other one in where its border reaches the
+	 *	same height, so this costs O(|height difference| + 1) after the O(log n) height checks.
+	 *	right is left empty; both trees need equal allocators since its nodes change owner.
+	 */
+	void join(const T &key, AVLTree &right)
 	{
-		if (rightNodeOfCurrNode != nullptr)
+		checkCanTakeNodes(right, "join");
+		if ((root != nullptr && !comp(rightmost(root)->getData(), key)) ||
+			(right.root != nullptr && !comp(key, leftmost(right.root)->getData())))
 		{
-			if (rightNodeOfCurrNode->hasLeft())
-			{
-				return findInorderSuccessor(rightNodeOfCurrNode->getLeft());
-			}
-			else
-			{
-				return rightNodeOfCurrNode;
-			}
+			throw std::invalid_argument("join: values have to be ordered as this tree < key < right");
 		}
 
-		return nullptr;
+		NodeType *keyNode = createNode(key);
+		right.shareNodeBlocks(*this);
+		root = joinSubtrees(wholeTree(), keyNode, right.wholeTree()).root;
+		right.root = nullptr;
+		right.releaseNodeBlocks();
 	}
 
-private:
-	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
-	void printTree(const std::string &prefix, AVLNode<T> *node, bool isLeft)
+	// join without a key in between: the largest value of this tree becomes the joining node
+	void join2(AVLTree &right)
 	{
-		if (node != nullptr)
+		checkCanTakeNodes(right, "join2");
+		if (root != nullptr && right.root != nullptr && !comp(rightmost(root)->getData(), leftmost(right.root)->getData()))
 		{
-			std::cout << prefix;
+			throw std::invalid_argument("join2: all values of this tree have to be less than the ones of right");
+		}
 
-			std::cout << (isLeft ? "|-- " : "\\-- ");
+		right.shareNodeBlocks(*this);
+		root = join2Subtrees(wholeTree(), right.wholeTree()).root;
+		right.root = nullptr;
+		right.releaseNodeBlocks();
+	}
 
-			// print the value of the node
-			std::cout << "(" << node->getData() << ", bf: " << (int)node->getBf() << ")" << std::endl;
+	/*
+	 *	Keeps the values less than key in this tree and moves the greater ones to the empty tree
+	 *	greater in O(log n): the subtrees hanging off either side of the search path of key are
+	 *	joined, each join paying only for the height difference. Returns whether key itself was in
+	 *	the tree, its node is destroyed.
+	 */
+	bool split(const T &key, AVLTree &greater)
+	{
+		checkCanTakeNodes(greater, "split");
+		if (greater.root != nullptr)
+		{
+			throw std::invalid_argument("split: greater has to be empty");
+		}
 
-			// enter the next tree level - left and right branch
-			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
-			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		shareNodeBlocks(greater);
+		const Split parts = splitSubtree(wholeTree(), key);
+		root = parts.less.root;
+		greater.root = parts.greater.root;
+		if (parts.middle == nullptr)
+		{
+			return false;
 		}
+		destroyNode(parts.middle);
+		return true;
 	}
 
-	AVLNode<T> *searchNode(const T &data, AVLNode<T> *currRoot)
+	/*
+	 *	Set operations of Blelloch, Ferizovic and Sun ("Just Join for Parallel Ordered Sets"):
+	 *	the root of other splits this tree, the two halves are combined recursively and joined
+	 *	again, which is O(m log(n / m + 1)) work for sizes m <= n instead of m insertions or
+	 *	removals of O(log n) each. The two recursive halves run on separate threads while threads
+	 *	are left (threadCount 0 means std::thread::hardware_concurrency()) and both trees are big
+	 *	enough to be worth it.
+	 *	The nodes are relinked, not copied: other is left empty, a value in both trees keeps the
+	 *	node of this tree, the dropped nodes are destroyed, and no node is allocated. Both trees
+	 *	need equal allocators, and comp must not throw as the trees are in pieces meanwhile.
+	 */
+	void unionWith(AVLTree &other, const size_t threadCount = 0)
 	{
-		if (currRoot != nullptr)
+		if (&other != this)
 		{
-			const auto currRootData = currRoot->getData();
+			runSetOperation(other, threadCount, &AVLTree::unionOf, "unionWith");
+		}
+	}
 
-			if (currRootData == data)
-				return currRoot;
+	// Keeps the values that are also in other
+	void intersectionWith(AVLTree &other, const size_t threadCount = 0)
+	{
+		if (&other != this)
+		{
+			runSetOperation(other, threadCount, &AVLTree::intersectionOf, "intersectionWith");
+		}
+	}
 
-			// search to the right if data > current data node
-			if (data > currRootData)
+	// Removes the values that are in other
+	void differenceWith(AVLTree &other, const size_t threadCount = 0)
+	{
+		if (&other == this)
+		{
+			clearTree();
+			return;
+		}
+		runSetOperation(other, threadCount, &AVLTree::differenceOf, "differenceWith");
+	}
+
+	NodeType *getRoot()
+	{
+		return this->root;
+	}
+
+	NodeType *searchNode(const T &data)
+	{
+		return searchNode<T>(data, root);
+	}
+
+	template <typename Key, typename = EnableLookup<Key>>
+	NodeType *searchNode(const Key &data)
+	{
+		return searchNode<Key>(data, root);
+	}
+
+	iterator begin()
+	{
+		return Iterator(leftmost(root), this);
+	}
+
+	iterator end()
+	{
+		return Iterator(nullptr, this);
+	}
+
+	const_iterator cbegin()
+	{
+		return begin();
+	}
+
+	const_iterator cend()
+	{
+		return end();
+	}
+
+	// Node with the smallest value not less than data, nullptr if all values are less
+	NodeType *lower_bound(const T &data)
+	{
+		return lower_bound<T>(data);
+	}
+
+	template <typename Key, typename = EnableLookup<Key>>
+	NodeType *lower_bound(const Key &data)
+	{
+		NodeType *bound = nullptr;
+		NodeType *currNode = root;
+		while (currNode != nullptr)
+		{
+			if (comp(currNode->getData(), data))
 			{
-				return searchNode(currRoot->getRight());
+				currNode = currNode->getRight();
 			}
-
-			// search to the left if data < current data node
-			if (data < currRootData)
+			else
 			{
-				return searchNode(currRoot->getLeft());
+				bound = currNode;
+				currNode = currNode->getLeft();
 			}
 		}
+		return bound;
+	}
 
-		return nullptr;
+	// Node with the smallest value greater than data, nullptr if there is none
+	NodeType *upper_bound(const T &data)
+	{
+		return upper_bound<T>(data);
 	}
 
-	inline void rebalanceTreeInsertion(
-		AVLNode<T> *parentNode,
-		AVLNode<T> *currNode,
-		const signed char bfDiff)
+	template <typename Key, typename = EnableLookup<Key>>
+	NodeType *upper_bound(const Key &data)
 	{
-		// increment/decrement bf value of parent node
-		parentNode->setBf(parentNode->getBf() + bfDiff);
+		NodeType *bound = nullptr;
+		NodeType *currNode = root;
+		while (currNode != nullptr)
+		{
+			if (comp(data, currNode->getData()))
+			{
+				bound = currNode;
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				currNode = currNode->getRight();
+			}
+		}
+		return bound;
+	}
 
-		const auto bfParent = parentNode->getBf();
+	// All values in [lo, hi] in order, e.g. for (const T &value : tree.range(lo, hi))
+	TreeRange<iterator> range(const T &lo, const T &hi)
+	{
+		return range<T, T>(lo, hi);
+	}
 
-		// Insertion: stop if during insertion and after modifying bf value of parent
-		// the bf value becomes 0
-		if (bfParent == 0)
+	template <typename LoKey, typename HiKey, typename = EnableLookup<LoKey>, typename = EnableLookup<HiKey>>
+	TreeRange<iterator> range(const LoKey &lo, const HiKey &hi)
+	{
+		// only compared with values of the tree, lo and hi may be of different key types
+		NodeType *first = lower_bound<LoKey>(lo);
+		if (first == nullptr || comp(hi, first->getData()))
 		{
-			return;
+			return TreeRange<iterator>(end(), end());
 		}
+		return TreeRange<iterator>(Iterator(first, this), Iterator(upper_bound<HiKey>(hi), this));
+	}
 
-		// the parent has unbalanced subtrees (invariant is violated)
-		if (bfParent < -1 || bfParent > 1)
+	// Number of values in the tree (needs an Augmentation that keeps subtree sizes)
+	size_t getSize()
+	{
+		static_assert(Augmentation::HAS_SIZE, "getSize needs an Augmentation that keeps subtree sizes");
+		return sizeOf(root);
+	}
+
+	// Node with the k-th smallest value (counting from 0), nullptr if k >= getSize()
+	NodeType *select(size_t k)
+	{
+		static_assert(Augmentation::HAS_SIZE, "select needs an Augmentation that keeps subtree sizes");
+		NodeType *currNode = root;
+		while (currNode != nullptr)
+		{
+			const size_t leftSize = sizeOf(currNode->getLeft());
+			if (k < leftSize)
+			{
+				currNode = currNode->getLeft();
+			}
+			else if (k == leftSize)
+			{
+				return currNode;
+			}
+			else
+			{
+				k -= leftSize + 1;
+				currNode = currNode->getRight();
+			}
+		}
+		return nullptr;
+	}
+
+	// Number of values less than data, i.e. the index select() has for data if it is in the tree
+	size_t rank(const T &data)
+	{
+		return rank<T>(data);
+	}
+
+	template <typename Key, typename = EnableLookup<Key>>
+	size_t rank(const Key &data)
+	{
+		static_assert(Augmentation::HAS_SIZE, "rank needs an Augmentation that keeps subtree sizes");
+		return countBelow(data, false);
+	}
+
+	// Number of values in [lo, hi]
+	size_t count(const T &lo, const T &hi)
+	{
+		return count<T>(lo, hi);
+	}
+
+	template <typename Key, typename = EnableLookup<Key>>
+	size_t count(const Key &lo, const Key &hi)
+	{
+		static_assert(Augmentation::HAS_SIZE, "count needs an Augmentation that keeps subtree sizes");
+		const size_t belowLo = countBelow(lo, false);
+		const size_t upToHi = countBelow(hi, true);
+		return upToHi > belowLo ? upToHi - belowLo : 0;
+	}
+
+	/*
+	 *	Monoid::combine over all values in [lo, hi] in ascending order, Monoid::identity() if there
+	 *	are none (needs AVLRangeAggregate). Descends to the highest node inside the range and from
+	 *	there along both of its borders: every subtree that hangs inside a border is taken as a whole
+	 *	from its summary, so at most 2 paths are visited.
+	 */
+	auto aggregate(const T &lo, const T &hi)
+	{
+		return aggregate<T>(lo, hi);
+	}
+
+	template <typename Key, typename = EnableLookup<Key>>
+	auto aggregate(const Key &lo, const Key &hi)
+	{
+		using Monoid = typename Augmentation::MonoidType;
+
+		NodeType *splitNode = root;
+		while (splitNode != nullptr)
+		{
+			if (comp(splitNode->getData(), lo))
+			{
+				splitNode = splitNode->getRight();
+			}
+			else if (comp(hi, splitNode->getData()))
+			{
+				splitNode = splitNode->getLeft();
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		if (splitNode == nullptr)
+		{
+			return Monoid::identity();
+		}
+
+		// values in [lo, splitNode), found from right to left
+		auto lowerPart = Monoid::identity();
+		for (NodeType *currNode = splitNode->getLeft(); currNode != nullptr;)
+		{
+			if (comp(currNode->getData(), lo))
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				auto part = Monoid::fromData(currNode->getData());
+				if (currNode->hasRight())
+				{
+					part = Monoid::combine(part, currNode->getRight()->getSummary().value);
+				}
+				lowerPart = Monoid::combine(part, lowerPart);
+				currNode = currNode->getLeft();
+			}
+		}
+
+		// values in (splitNode, hi], found from left to right
+		auto upperPart = Monoid::identity();
+		for (NodeType *currNode = splitNode->getRight(); currNode != nullptr;)
+		{
+			if (comp(hi, currNode->getData()))
+			{
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				auto part = Monoid::fromData(currNode->getData());
+				if (currNode->hasLeft())
+				{
+					part = Monoid::combine(currNode->getLeft()->getSummary().value, part);
+				}
+				upperPart = Monoid::combine(upperPart, part);
+				currNode = currNode->getRight();
+			}
+		}
+
+		return Monoid::combine(Monoid::combine(lowerPart, Monoid::fromData(splitNode->getData())), upperPart);
+	}
+
+	inline NodeType *findInorderSuccessor(NodeType *rightNodeOfCurrNode)
+	{
+		if (rightNodeOfCurrNode != nullptr)
+		{
+			if (rightNodeOfCurrNode->hasLeft())
+			{
+				return findInorderSuccessor(rightNodeOfCurrNode->getLeft());
+			}
+			else
+			{
+				return rightNodeOfCurrNode;
+			}
+		}
+
+		return nullptr;
+	}
+
+private:
+	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
+	void printTree(const std::string &prefix, NodeType *node, bool isLeft)
+	{
+		if (node != nullptr)
+		{
+			std::cout << prefix;
+
+			std::cout << (isLeft ? "|-- " : "\\-- ");
+
+			// print the value of the node
+			std::cout << "(" << node->getData() << ", bf: " << (int)node->getBf() << ")" << std::endl;
+
+			// enter the next tree level - left and right branch
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getLeft(), true);
+			printTree(prefix + (isLeft ? "|   " : "    "), node->getRight(), false);
+		}
+	}
+
+	template <typename Key>
+	NodeType *searchNode(const Key &data, NodeType *currRoot)
+	{
+		if (currRoot != nullptr)
+		{
+			const T &currRootData = currRoot->getData();
+
+			// search to the right if data > current data node
+			if (comp(currRootData, data))
+			{
+				return searchNode(data, currRoot->getRight());
+			}
+
+			// search to the left if data < current data node
+			if (comp(data, currRootData))
+			{
+				return searchNode(data, currRoot->getLeft());
+			}
+
+			// neither is smaller, so they are equivalent
+			return currRoot;
+		}
+
+		return nullptr;
+	}
+
+	inline void rebalanceTreeInsertion(
+		NodeType *parentNode,
+		NodeType *currNode,
+		const signed char bfDiff)
+	{
+		// increment/decrement bf value of parent node
+		parentNode->setBf(parentNode->getBf() + bfDiff);
+
+		const auto bfParent = parentNode->getBf();
+
+		// Insertion: stop if during insertion and after modifying bf value of parent
+		// the bf value becomes 0
+		if (bfParent == 0)
+		{
+			return;
+		}
+
+		// the parent has unbalanced subtrees (invariant is violated)
+		if (bfParent < -1 || bfParent > 1)
 		{
 			// FROM WIKIPEDIA:
 			// The rebalancing is performed differently :
@@ -690,149 +1189,214 @@ private:
 		}
 	}
 
-	void rebalanceTreeDeletion(AVLNode<T> *currNode, const signed char bfDiff) // TODO:
+	void rebalanceTreeDeletion(NodeType *currNode, signed char bfDiff)
 	{
-		if (currNode == nullptr)
+		while (currNode != nullptr)
 		{
-			return;
-		}
-
-		// increment/decrement bf value of parent node
-		currNode->setBf(currNode->getBf() + bfDiff);
-
-		const auto currNodeBf = currNode->getBf();
+			// increment/decrement bf value of the node whose subtree lost one level
+			currNode->setBf(currNode->getBf() + bfDiff);
 
-		// This variable is only used when a rotation happened because of unbalanced tree
-		// In this case next parent would be parent of returned node after rotation.
-		AVLNode<T> *nextParentAfterRotation = nullptr;
+			const auto currNodeBf = currNode->getBf();
 
-		// Deletion: stop if after deletion of node and modifying bf value of parent of the deleted
-		// node the bf value becomes -1 or +1
-		if (currNodeBf == -1 || currNodeBf == 1)
-		{
-			return;
-		}
-		// the parent has unbalanced subtrees and is left-heavy (invariant is violated)
-		// taking left child as child node for rotation
-		else if (currNodeBf < -1)
-		{
-			AVLNode<T> *currNodeLeft = currNode->getLeft();
-			const auto currNodeLeftBf = currNodeLeft->getBf();
+			// Deletion: stop if the bf value becomes -1 or +1, the height of the subtree of
+			// currNode did not change
+			if (currNodeBf == -1 || currNodeBf == 1)
+			{
+				return;
+			}
 
-			if (currNodeLeftBf <= 0) // Left Left	- Z is a left	child of its parent X and BF(Z) <= 0
+			// the node has unbalanced subtrees (invariant is violated)
+			if (currNodeBf < -1 || currNodeBf > 1)
 			{
-				nextParentAfterRotation = rotateRight(currNode, currNodeLeft);
-				if (currNode == root)
+				NodeType *rotatedRoot = nullptr;
+
+				if (currNodeBf < -1)
 				{
-					root = nextParentAfterRotation;
+					// left-heavy, taking left child as child node for rotation
+					NodeType *currNodeLeft = currNode->getLeft();
+					if (currNodeLeft->getBf() <= 0) // Left Left	- Z is a left	child of its parent X and BF(Z) <= 0
+					{
+						rotatedRoot = rotateRight(currNode, currNodeLeft);
+					}
+					else // Left Right	- Z is a left	child of its parent X and BF(Z) > 0
+					{
+						rotatedRoot = rotateLeftRight(currNode, currNodeLeft);
+					}
 				}
-			}
-			else if (currNodeLeftBf > 0) // Left Right	- Z is a left	child of its parent X and BF(Z) > 0
-			{
-				nextParentAfterRotation = rotateLeftRight(currNode, currNodeLeft);
-				if (currNode == root)
+				else
 				{
-					root = nextParentAfterRotation;
+					// right-heavy, taking right child as child node for rotation
+					NodeType *currNodeRight = currNode->getRight();
+					if (currNodeRight->getBf() >= 0) // Right Right	- Z is a right	child of its parent X and BF(Z) >= 0
+					{
+						rotatedRoot = rotateLeft(currNode, currNodeRight);
+					}
+					else // Right Left	- Z is a right	child of its parent X and BF(Z) < 0
+					{
+						rotatedRoot = rotateRightLeft(currNode, currNodeRight);
+					}
 				}
-			}
-			else
-			{
-				std::cout << "[rebalanceTreeDeletion] {currNodeBf < -1} should not ever come here. Bug detected";
-			}
-		}
-		// the parent has unbalanced subtrees and is right-heavy (invariant is violated)
-		else if (currNodeBf > 1)
-		{
-			AVLNode<T> *currNodeRight = currNode->getRight();
-			const auto currNodeRightBf = currNodeRight->getBf();
 
-			if (currNodeRightBf >= 0) // Right Right	- Z is a right	child of its parent X and BF(Z) >= 0
-			{
-				nextParentAfterRotation = rotateLeft(currNode, currNodeRight);
 				if (currNode == root)
 				{
-					root = nextParentAfterRotation;
+					root = rotatedRoot;
 				}
-			}
-			else if (currNodeRightBf < 0) // Right Left	- Z is a right	child of its parent X and BF(Z) < 0
-			{
-				nextParentAfterRotation = rotateRightLeft(currNode, currNodeRight);
-				if (currNode == root)
+				currNode = rotatedRoot;
+
+				// a simple rotation around a child with bf 0 keeps the height of the subtree,
+				// nothing above it changes
+				if (currNode->getBf() != 0)
 				{
-					root = nextParentAfterRotation;
+					return;
 				}
 			}
-			else
+
+			// the subtree of currNode lost one level, continue with its parent
+			NodeType *parentNode = currNode->getParent();
+			if (parentNode == nullptr)
 			{
-				std::cout << "[rebalanceTreeDeletion] {currNodeBf > 1} should not ever come here. Bug detected";
+				return;
 			}
+			bfDiff = isRightChild(parentNode, currNode) ? DECREMENT_BF : INCREMENT_BF;
+			currNode = parentNode;
 		}
+	}
 
-		AVLNode<T> *nextParent = nullptr;
-
-		if (nextParentAfterRotation == nullptr)
+	void rebalanceTreeDeletion(NodeType *parentDeletedNode, bool rightIsDeleted)
+	{
+		if (rightIsDeleted)
 		{
-			// no rotation has occured, continue with parent of current node
-			nextParent = currNode->getParent();
+			// if node is deleted from the right subtree, then subtract 1 to current parent node
+			rebalanceTreeDeletion(parentDeletedNode, DECREMENT_BF);
 		}
 		else
 		{
-			// a rotation has occured, continue with parent of returned rotated node
-			nextParent = nextParentAfterRotation->getParent();
-			// assign currNode to node after rotation since currNode (where we are now) changes after rotation
-			// so this is done to keep parent and currNode aligned with each other so that isRightChild check is
-			// done correctly.
-			currNode = nextParentAfterRotation;
+			// if node is deleted from the left subtree, then increment 1 to current parent node
+			rebalanceTreeDeletion(parentDeletedNode, INCREMENT_BF);
 		}
+	}
+
+	void rebalanceTreeInsertion(NodeType *insertedNode)
+	{
+		NodeType *parentCurrNode = insertedNode->getParent();
 
-		if (nextParent != nullptr)
+		// if the root is inserted, then no updates are needed since the tree is already balanced.
+		if (parentCurrNode != nullptr)
 		{
-			if (isRightChild(nextParent, currNode))
+			if (isRightChild(parentCurrNode, insertedNode))
 			{
-				return rebalanceTreeDeletion(nextParent, DECREMENT_BF);
+				// if node is inserted to the right, then add 1 to direct parent node
+				rebalanceTreeInsertion(parentCurrNode, insertedNode, INCREMENT_BF);
 			}
 			else
 			{
-				return rebalanceTreeDeletion(nextParent, INCREMENT_BF);
+				// if node is inserted to the left, then subtract 1 to direct parent node
+				rebalanceTreeInsertion(parentCurrNode, insertedNode, DECREMENT_BF);
 			}
 		}
 	}
 
-	void rebalanceTreeDeletion(AVLNode<T> *parentDeletedNode, bool rightIsDeleted)
+	// Lets the parent of oldNode (or root if it has none) point to newNode instead
+	inline void replaceInParent(NodeType *oldNode, NodeType *newNode)
 	{
-		if (rightIsDeleted)
+		NodeType *parentNode = oldNode->getParent();
+		if (parentNode == nullptr)
 		{
-			// if node is deleted from the right subtree, then subtract 1 to current parent node
-			rebalanceTreeDeletion(parentDeletedNode, DECREMENT_BF);
+			root = newNode;
 		}
 		else
 		{
-			// if node is deleted from the left subtree, then increment 1 to current parent node
-			rebalanceTreeDeletion(parentDeletedNode, INCREMENT_BF);
+			setChildFromParent(parentNode, oldNode, newNode);
+		}
+
+		if (newNode != nullptr)
+		{
+			newNode->setParent(parentNode);
 		}
 	}
 
-	void rebalanceTreeInsertion(AVLNode<T> *insertedNode)
+	/*
+	 *	Recompute the summaries from node up to the root. Rotations only update the nodes they move,
+	 *	every other node whose subtree changed by an insertion or removal is an ancestor of node.
+	 */
+	inline void updateSummariesToRoot(NodeType *node)
 	{
-		AVLNode<T> *parentCurrNode = insertedNode->getParent();
+		if constexpr (Augmentation::HAS_SUMMARY)
+		{
+			for (; node != nullptr; node = node->getParent())
+			{
+				node->updateSummary();
+			}
+		}
+	}
 
-		// if the root is inserted, then no updates are needed since the tree is already balanced.
-		if (parentCurrNode != nullptr)
+	// Smallest node of the subtree, prefetching the right children an in-order walk visits next
+	static NodeType *leftmost(NodeType *node)
+	{
+		if (node != nullptr)
 		{
-			if (isRightChild(parentCurrNode, insertedNode))
+			while (node->hasLeft())
 			{
-				// if node is inserted to the right, then add 1 to direct parent node
-				rebalanceTreeInsertion(parentCurrNode, insertedNode, INCREMENT_BF);
+				prefetch(node->getRight());
+				node = node->getLeft();
+			}
+			prefetch(node->getRight());
+		}
+		return node;
+	}
+
+	// Largest node of the subtree, prefetching the left children a reverse walk visits next
+	static NodeType *rightmost(NodeType *node)
+	{
+		if (node != nullptr)
+		{
+			while (node->hasRight())
+			{
+				prefetch(node->getLeft());
+				node = node->getRight();
+			}
+			prefetch(node->getLeft());
+		}
+		return node;
+	}
+
+	static void prefetch(const void *address)
+	{
+#if defined(_MSC_VER)
+		_mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+		__builtin_prefetch(address);
+#endif
+	}
+
+	static size_t sizeOf(NodeType *node)
+	{
+		return node != nullptr ? node->getSummary().size : 0;
+	}
+
+	// Number of values less than data, or not greater than data if inclusive
+	template <typename Key>
+	size_t countBelow(const Key &data, const bool inclusive)
+	{
+		size_t below = 0;
+		NodeType *currNode = root;
+		while (currNode != nullptr)
+		{
+			if (inclusive ? !comp(data, currNode->getData()) : comp(currNode->getData(), data))
+			{
+				// currNode and its whole left subtree are below data
+				below += sizeOf(currNode->getLeft()) + 1;
+				currNode = currNode->getRight();
 			}
 			else
 			{
-				// if node is inserted to the left, then subtract 1 to direct parent node
-				rebalanceTreeInsertion(parentCurrNode, insertedNode, DECREMENT_BF);
+				currNode = currNode->getLeft();
 			}
 		}
+		return below;
 	}
 
-	inline bool isRightChild(AVLNode<T> *parentNode, AVLNode<T> *nodeToCheck)
+	inline bool isRightChild(NodeType *parentNode, NodeType *nodeToCheck)
 	{
 		if (parentNode->getRight() == nodeToCheck)
 		{
@@ -842,9 +1406,9 @@ private:
 	}
 
 	inline void setChildFromParent(
-		AVLNode<T> *parentNode,
-		AVLNode<T> *childToSet,
-		AVLNode<T> *newRefToSetTo)
+		NodeType *parentNode,
+		NodeType *childToSet,
+		NodeType *newRefToSetTo)
 	{
 		if (parentNode != nullptr)
 		{
@@ -859,7 +1423,582 @@ private:
 		}
 	}
 
-	void cleanUpTree(AVLNode<T> *currNode)
+	// Detached subtree (its root has no parent) together with its height, which join needs
+	struct Subtree
+	{
+		NodeType *root;
+		int height;
+	};
+
+	// Values less than middle, the node middle (may be nullptr) and values greater than middle
+	struct Split
+	{
+		Subtree less;
+		NodeType *middle;
+		Subtree greater;
+	};
+
+	// Subtrees dropped by a set operation, chained through the parent pointers of their roots
+	struct DiscardedNodes
+	{
+		NodeType *head = nullptr;
+		NodeType *tail = nullptr;
+
+		void add(NodeType *subtree)
+		{
+			if (subtree != nullptr)
+			{
+				subtree->setParent(head);
+				head = subtree;
+				if (tail == nullptr)
+				{
+					tail = subtree;
+				}
+			}
+		}
+
+		void splice(DiscardedNodes &other)
+		{
+			if (other.head != nullptr)
+			{
+				other.tail->setParent(head);
+				head = other.head;
+				if (tail == nullptr)
+				{
+					tail = other.tail;
+				}
+				other.head = other.tail = nullptr;
+			}
+		}
+	};
+
+	using SetOperation = Subtree (AVLTree::*)(Subtree, Subtree, size_t, DiscardedNodes &);
+
+	// Subtrees smaller than this are combined on the thread that reached them
+	static constexpr int MIN_FORK_HEIGHT = 12;
+
+	void checkCanTakeNodes(const AVLTree &other, const char *operation) const
+	{
+		if (&other == this)
+		{
+			throw std::invalid_argument(std::string(operation) + ": the trees have to be different");
+		}
+		if (!(nodeAllocator == other.nodeAllocator))
+		{
+			throw std::invalid_argument(std::string(operation) + ": the trees use different allocators");
+		}
+	}
+
+	Subtree wholeTree() const
+	{
+		return Subtree{root, heightOf(root)};
+	}
+
+	// Follows the higher child down, O(log n)
+	static int heightOf(NodeType *node)
+	{
+		int height = 0;
+		for (; node != nullptr; node = node->getBf() < 0 ? node->getLeft() : node->getRight())
+		{
+			++height;
+		}
+		return height;
+	}
+
+	// Detaches the root of tree from its children, the heights of which follow from its bf
+	static Split expose(const Subtree tree)
+	{
+		NodeType *node = tree.root;
+		const Split parts{
+			Subtree{node->getLeft(), tree.height - (node->getBf() > 0 ? 2 : 1)},
+			node,
+			Subtree{node->getRight(), tree.height - (node->getBf() < 0 ? 2 : 1)}};
+
+		if (parts.less.root != nullptr)
+		{
+			parts.less.root->setParent(nullptr);
+		}
+		if (parts.greater.root != nullptr)
+		{
+			parts.greater.root->setParent(nullptr);
+		}
+		node->setLeft(nullptr);
+		node->setRight(nullptr);
+		return parts;
+	}
+
+	static void linkChildren(NodeType *node, const Subtree left, const Subtree right)
+	{
+		node->setLeft(left.root);
+		node->setRight(right.root);
+		if (left.root != nullptr)
+		{
+			left.root->setParent(node);
+		}
+		if (right.root != nullptr)
+		{
+			right.root->setParent(node);
+		}
+		node->setBf(static_cast<signed char>(right.height - left.height));
+		node->updateSummary();
+	}
+
+	/*
+	 *	Balanced tree of left, node and right (all of left < node < all of right). If the heights
+	 *	differ by more than one, node goes down the inner border of the taller tree to the first
+	 *	subtree at most one level higher than the other tree and takes both as its children. That
+	 *	subtree grows by one level, which is rebalanced like an insertion.
+	 */
+	Subtree joinSubtrees(const Subtree left, NodeType *node, const Subtree right)
+	{
+		if (left.height > right.height + 1)
+		{
+			return joinIntoLeft(left, node, right);
+		}
+		if (right.height > left.height + 1)
+		{
+			return joinIntoRight(left, node, right);
+		}
+
+		linkChildren(node, left, right);
+		node->setParent(nullptr);
+		return Subtree{node, std::max(left.height, right.height) + 1};
+	}
+
+	// left is higher, node and right go down its right border
+	Subtree joinIntoLeft(const Subtree left, NodeType *node, const Subtree right)
+	{
+		NodeType *parentNode = nullptr;
+		NodeType *borderNode = left.root;
+		int borderHeight = left.height;
+		while (borderHeight > right.height + 1)
+		{
+			borderHeight -= borderNode->getBf() < 0 ? 2 : 1;
+			parentNode = borderNode;
+			borderNode = borderNode->getRight();
+		}
+
+		linkChildren(node, Subtree{borderNode, borderHeight}, right);
+		node->setParent(parentNode);
+		parentNode->setRight(node);
+
+		// the right subtree of every node on the border above node grew by one level
+		NodeType *top = left.root;
+		NodeType *currNode = node;
+		bool grown = true;
+		for (; grown && parentNode != nullptr; parentNode = currNode->getParent())
+		{
+			parentNode->setBf(parentNode->getBf() + INCREMENT_BF);
+			if (parentNode->getBf() == 0)
+			{
+				grown = false;
+			}
+			else if (parentNode->getBf() > 1)
+			{
+				// currNode has bf 0 or -1 here, the rotation restores the old height
+				NodeType *rotatedRoot = currNode->getBf() < 0 ? rotateRightLeft(parentNode, currNode) : rotateLeft(parentNode, currNode);
+				if (parentNode == top)
+				{
+					top = rotatedRoot;
+				}
+				grown = false;
+			}
+			else
+			{
+				currNode = parentNode;
+			}
+		}
+
+		updateSummariesToRoot(node);
+		return Subtree{top, left.height + (grown ? 1 : 0)};
+	}
+
+	// right is higher, left and node go down its left border
+	Subtree joinIntoRight(const Subtree left, NodeType *node, const Subtree right)
+	{
+		NodeType *parentNode = nullptr;
+		NodeType *borderNode = right.root;
+		int borderHeight = right.height;
+		while (borderHeight > left.height + 1)
+		{
+			borderHeight -= borderNode->getBf() > 0 ? 2 : 1;
+			parentNode = borderNode;
+			borderNode = borderNode->getLeft();
+		}
+
+		linkChildren(node, left, Subtree{borderNode, borderHeight});
+		node->setParent(parentNode);
+		parentNode->setLeft(node);
+
+		// the left subtree of every node on the border above node grew by one level
+		NodeType *top = right.root;
+		NodeType *currNode = node;
+		bool grown = true;
+		for (; grown && parentNode != nullptr; parentNode = currNode->getParent())
+		{
+			parentNode->setBf(parentNode->getBf() + DECREMENT_BF);
+			if (parentNode->getBf() == 0)
+			{
+				grown = false;
+			}
+			else if (parentNode->getBf() < -1)
+			{
+				// currNode has bf 0 or +1 here, the rotation restores the old height
+				NodeType *rotatedRoot = currNode->getBf() > 0 ? rotateLeftRight(parentNode, currNode) : rotateRight(parentNode, currNode);
+				if (parentNode == top)
+				{
+					top = rotatedRoot;
+				}
+				grown = false;
+			}
+			else
+			{
+				currNode = parentNode;
+			}
+		}
+
+		updateSummariesToRoot(node);
+		return Subtree{top, right.height + (grown ? 1 : 0)};
+	}
+
+	// Splits tree along the search path of key, joining the subtrees hanging off each side of it
+	template <typename Key>
+	Split splitSubtree(const Subtree tree, const Key &key)
+	{
+		if (tree.root == nullptr)
+		{
+			return Split{tree, nullptr, tree};
+		}
+
+		Split parts = expose(tree);
+		if (comp(key, parts.middle->getData()))
+		{
+			Split lower = splitSubtree(parts.less, key);
+			lower.greater = joinSubtrees(lower.greater, parts.middle, parts.greater);
+			return lower;
+		}
+		if (comp(parts.middle->getData(), key))
+		{
+			Split upper = splitSubtree(parts.greater, key);
+			upper.less = joinSubtrees(parts.less, parts.middle, upper.less);
+			return upper;
+		}
+		return parts;
+	}
+
+	// Unlinks the largest node of the non-empty tree, returned as middle with the rest as less
+	Split splitLast(const Subtree tree)
+	{
+		Split parts = expose(tree);
+		if (parts.greater.root == nullptr)
+		{
+			return parts;
+		}
+
+		Split last = splitLast(parts.greater);
+		last.less = joinSubtrees(parts.less, parts.middle, last.less);
+		return last;
+	}
+
+	Subtree join2Subtrees(const Subtree left, const Subtree right)
+	{
+		if (left.root == nullptr)
+		{
+			return right;
+		}
+		const Split parts = splitLast(left);
+		return joinSubtrees(parts.less, parts.middle, right);
+	}
+
+	Subtree unionOf(const Subtree mine, const Subtree theirs, const size_t threadCount, DiscardedNodes &discarded)
+	{
+		if (mine.root == nullptr)
+		{
+			return theirs;
+		}
+		if (theirs.root == nullptr)
+		{
+			return mine;
+		}
+
+		const Split theirParts = expose(theirs);
+		const Split myParts = splitSubtree(mine, theirParts.middle->getData());
+		NodeType *middle = theirParts.middle;
+		if (myParts.middle != nullptr)
+		{
+			discarded.add(middle);
+			middle = myParts.middle;
+		}
+
+		Subtree less{nullptr, 0};
+		Subtree greater{nullptr, 0};
+		forkSetOperation(
+			threadCount, std::min(mine.height, theirs.height), discarded,
+			[&](const size_t threads, DiscardedNodes &discardedLess) { less = unionOf(myParts.less, theirParts.less, threads, discardedLess); },
+			[&](const size_t threads, DiscardedNodes &discardedGreater) { greater = unionOf(myParts.greater, theirParts.greater, threads, discardedGreater); });
+		return joinSubtrees(less, middle, greater);
+	}
+
+	Subtree intersectionOf(const Subtree mine, const Subtree theirs, const size_t threadCount, DiscardedNodes &discarded)
+	{
+		if (mine.root == nullptr || theirs.root == nullptr)
+		{
+			discarded.add(mine.root);
+			discarded.add(theirs.root);
+			return Subtree{nullptr, 0};
+		}
+
+		const Split theirParts = expose(theirs);
+		const Split myParts = splitSubtree(mine, theirParts.middle->getData());
+		discarded.add(theirParts.middle);
+
+		Subtree less{nullptr, 0};
+		Subtree greater{nullptr, 0};
+		forkSetOperation(
+			threadCount, std::min(mine.height, theirs.height), discarded,
+			[&](const size_t threads, DiscardedNodes &discardedLess) { less = intersectionOf(myParts.less, theirParts.less, threads, discardedLess); },
+			[&](const size_t threads, DiscardedNodes &discardedGreater) { greater = intersectionOf(myParts.greater, theirParts.greater, threads, discardedGreater); });
+		return myParts.middle != nullptr ? joinSubtrees(less, myParts.middle, greater) : join2Subtrees(less, greater);
+	}
+
+	Subtree differenceOf(const Subtree mine, const Subtree theirs, const size_t threadCount, DiscardedNodes &discarded)
+	{
+		if (mine.root == nullptr || theirs.root == nullptr)
+		{
+			discarded.add(theirs.root);
+			return mine;
+		}
+
+		const Split theirParts = expose(theirs);
+		const Split myParts = splitSubtree(mine, theirParts.middle->getData());
+		discarded.add(theirParts.middle);
+		discarded.add(myParts.middle);
+
+		Subtree less{nullptr, 0};
+		Subtree greater{nullptr, 0};
+		forkSetOperation(
+			threadCount, std::min(mine.height, theirs.height), discarded,
+			[&](const size_t threads, DiscardedNodes &discardedLess) { less = differenceOf(myParts.less, theirParts.less, threads, discardedLess); },
+			[&](const size_t threads, DiscardedNodes &discardedGreater) { greater = differenceOf(myParts.greater, theirParts.greater, threads, discardedGreater); });
+		return join2Subtrees(less, greater);
+	}
+
+	/*
+	 *	Runs both halves of a set operation, the lower one on a new thread if threads are left and
+	 *	the trees are high enough. Only the calling thread of the whole operation destroys nodes,
+	 *	so each thread collects the ones it drops in its own list.
+	 */
+	template <typename Less, typename Greater>
+	static void forkSetOperation(const size_t threadCount, const int height, DiscardedNodes &discarded, Less less, Greater greater)
+	{
+		if (threadCount <= 1 || height < MIN_FORK_HEIGHT)
+		{
+			less(1, discarded);
+			greater(1, discarded);
+			return;
+		}
+
+		DiscardedNodes discardedLess;
+		const auto errors = tree_detail::forkJoin(
+			threadCount,
+			[&](const size_t threads) { less(threads, discardedLess); },
+			[&](const size_t threads) { greater(threads, discarded); });
+		discarded.splice(discardedLess);
+		if (errors.first || errors.second)
+		{
+			std::rethrow_exception(errors.first ? errors.first : errors.second);
+		}
+	}
+
+	void runSetOperation(AVLTree &other, size_t threadCount, const SetOperation operation, const char *name)
+	{
+		checkCanTakeNodes(other, name);
+		other.shareNodeBlocks(*this);
+		if (threadCount == 0)
+		{
+			threadCount = std::thread::hardware_concurrency();
+		}
+
+		const Subtree mine = wholeTree();
+		const Subtree theirs = other.wholeTree();
+		root = nullptr;
+		other.root = nullptr;
+		other.releaseNodeBlocks();
+
+		DiscardedNodes discarded;
+		root = (this->*operation)(mine, theirs, threadCount, discarded).root;
+
+		while (discarded.head != nullptr)
+		{
+			NodeType *subtree = discarded.head;
+			discarded.head = subtree->getParent();
+			cleanUpTree(subtree);
+		}
+	}
+
+	// Constructs the nodes of build_from_sorted in their block, see tree_detail::buildBalanced
+	template <typename ValueAt>
+	struct NodeBuilder
+	{
+		AVLTree &tree;
+		NodeType *block;
+		ValueAt valueAt;
+
+		NodeType *construct(const size_t index, NodeType *left)
+		{
+			NodeType *node = block + index;
+			NodeAllocatorTraits::construct(tree.nodeAllocator, node, valueAt(index));
+			node->setLeft(left);
+			if (left != nullptr)
+			{
+				left->setParent(node);
+			}
+			return node;
+		}
+
+		void attachRight(NodeType *node, NodeType *right, const size_t leftCount, const size_t rightCount)
+		{
+			node->setRight(right);
+			if (right != nullptr)
+			{
+				right->setParent(node);
+			}
+			// both halves are perfectly balanced, so their heights follow from their sizes
+			node->setBf(static_cast<signed char>(tree_detail::heightOf(rightCount) - tree_detail::heightOf(leftCount)));
+			node->updateSummary();
+		}
+
+		void destroyRange(const size_t lo, const size_t hi)
+		{
+			for (size_t i = lo; i < hi; ++i)
+			{
+				NodeAllocatorTraits::destroy(tree.nodeAllocator, block + i);
+			}
+		}
+	};
+
+	template <typename Builder>
+	void buildFromBlock(Builder &builder, const size_t count, const size_t threadCount)
+	{
+		try
+		{
+			root = threadCount > 1
+					   ? tree_detail::buildBalancedParallel<NodeType>(0, count, threadCount, builder)
+					   : tree_detail::buildBalanced<NodeType>(0, count, builder);
+		}
+		catch (...)
+		{
+			releaseNodeBlocks();
+			throw;
+		}
+	}
+
+	/*
+	 *	Block of nodes from build_from_sorted. join, split and the set operations move nodes between
+	 *	trees, so every tree holding nodes of a block shares it and the last one frees it.
+	 */
+	struct NodeBlock
+	{
+		NodeBlock(const NodeAllocator &allocator, NodeType *nodes, const size_t count)
+			: allocator(allocator),
+			  nodes(nodes),
+			  count(count)
+		{
+		}
+
+		// Delete constructors which may cause headache and bugs
+		NodeBlock(const NodeBlock &) = delete;
+		NodeBlock(NodeBlock &&) = delete;
+
+		~NodeBlock()
+		{
+			NodeAllocatorTraits::deallocate(allocator, nodes, count);
+		}
+
+		NodeAllocator allocator;
+		NodeType *nodes;
+		size_t count;
+	};
+
+	NodeType *allocateNodeBlock(const size_t count)
+	{
+		NodeType *block = NodeAllocatorTraits::allocate(nodeAllocator, count);
+		try
+		{
+			nodeBlocks.push_back(std::make_shared<NodeBlock>(nodeAllocator, block, count));
+		}
+		catch (...)
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, block, count);
+			throw;
+		}
+		return block;
+	}
+
+	bool isBlockNode(const NodeType *node) const
+	{
+		const std::less<> before;
+		for (const auto &block : nodeBlocks)
+		{
+			if (!before(node, block->nodes) && before(node, block->nodes + block->count))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// other may hold nodes of every block of this tree from now on
+	void shareNodeBlocks(AVLTree &other) const
+	{
+		for (const auto &block : nodeBlocks)
+		{
+			if (std::find(other.nodeBlocks.begin(), other.nodeBlocks.end(), block) == other.nodeBlocks.end())
+			{
+				other.nodeBlocks.push_back(block);
+			}
+		}
+	}
+
+	void releaseNodeBlocks()
+	{
+		nodeBlocks.clear();
+	}
+
+	void clearTree()
+	{
+		cleanUpTree(root);
+		root = nullptr;
+		releaseNodeBlocks();
+	}
+
+	template <typename... Args>
+	NodeType *createNode(Args &&...args)
+	{
+		NodeType *node = NodeAllocatorTraits::allocate(nodeAllocator, 1);
+		try
+		{
+			NodeAllocatorTraits::construct(nodeAllocator, node, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void destroyNode(NodeType *node)
+	{
+		NodeAllocatorTraits::destroy(nodeAllocator, node);
+		// nodes of a block are given back with their block
+		if (!isBlockNode(node))
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+		}
+	}
+
+	void cleanUpTree(NodeType *currNode)
 	{
 		// Post-order traversal to delete and free up memory taken by each node.
 		// First the left three and right tree are visited and deleted first and then the current node is deleted so
@@ -877,12 +2016,15 @@ private:
 				cleanUpTree(currNode->getRight());
 			}
 
-			delete currNode;
+			destroyNode(currNode);
 		}
 	}
 
 private:
-	AVLNode<T> *root;
+	NodeType *root;
+	Compare comp;
+	NodeAllocator nodeAllocator;
+	std::vector<std::shared_ptr<NodeBlock>> nodeBlocks; // blocks with nodes of this tree, freed as a whole
 	const signed char INCREMENT_BF = 1;
 	const signed char DECREMENT_BF = -1;
 };
\ No newline at end of file
@@ -0,0 +1 @@
+#include <PoolAllocator.h>
\ No newline at end of file
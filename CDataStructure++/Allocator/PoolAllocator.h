@@ -0,0 +1,257 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/*
+*	Slab allocator for small fixed size objects such as list and tree nodes.
+*	Requests are rounded up to a multiple of GRANULARITY bytes and every size class keeps its own
+*	free list. New blocks are carved from SLAB_SIZE byte slabs, so after warm up an allocation or
+*	deallocation is a pointer push/pop instead of a malloc/free call. Slabs are only returned to
+*	the system all at once, by release() or when the pool is destroyed.
+*	Larger requests go straight to operator new. Not thread-safe.
+*/
+class SlabPool
+{
+public:
+	static constexpr size_t GRANULARITY = alignof(std::max_align_t);
+	static constexpr size_t MAX_BLOCK_SIZE = 256;
+	static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+public:
+	SlabPool()
+		:
+		releasing(false)
+	{
+		for (SizeClass& sizeClass : sizeClasses)
+		{
+			sizeClass = SizeClass();
+		}
+	}
+
+	// Delete constructors which may cause headache and bugs
+	SlabPool(const SlabPool&) = delete;
+	SlabPool(SlabPool&&) = delete;
+
+	~SlabPool()
+	{
+		release();
+	}
+
+	static bool isPooled(const size_t bytes, const size_t alignment)
+	{
+		return bytes <= MAX_BLOCK_SIZE && alignment <= GRANULARITY;
+	}
+
+	void* allocate(const size_t bytes)
+	{
+		SizeClass& sizeClass = sizeClasses[classOf(bytes)];
+		if (sizeClass.freeList != nullptr)
+		{
+			FreeBlock* block = sizeClass.freeList;
+			sizeClass.freeList = block->next;
+			return block;
+		}
+
+		const size_t blockSize = (classOf(bytes) + 1) * GRANULARITY;
+		if (sizeClass.bumpEnd - sizeClass.bumpNext < static_cast<std::ptrdiff_t>(blockSize))
+		{
+			char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+			try
+			{
+				slabs.push_back(slab);
+			}
+			catch (...)
+			{
+				::operator delete(slab);
+				throw;
+			}
+			sizeClass.bumpNext = slab;
+			sizeClass.bumpEnd = slab + SLAB_SIZE;
+		}
+
+		void* block = sizeClass.bumpNext;
+		sizeClass.bumpNext += blockSize;
+		return block;
+	}
+
+	void deallocate(void* block, const size_t bytes)
+	{
+		SizeClass& sizeClass = sizeClasses[classOf(bytes)];
+		FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+		freeBlock->next = sizeClass.freeList;
+		sizeClass.freeList = freeBlock;
+	}
+
+	/*
+	*	Frees every slab at once. All blocks handed out by the pool become invalid.
+	*/
+	void release()
+	{
+		for (char* slab : slabs)
+		{
+			::operator delete(slab);
+		}
+		slabs.clear();
+		for (SizeClass& sizeClass : sizeClasses)
+		{
+			sizeClass = SizeClass();
+		}
+		releasing = false;
+	}
+
+	/*
+	*	Announces that the pool is about to be destroyed together with every container using it,
+	*	so those containers may skip returning their nodes one by one (see poolFreesInBulk).
+	*/
+	void beginRelease()
+	{
+		releasing = true;
+	}
+
+	bool isReleasing() const
+	{
+		return releasing;
+	}
+
+	size_t getSlabCount() const
+	{
+		return slabs.size();
+	}
+
+	size_t getReservedBytes() const
+	{
+		return slabs.size() * SLAB_SIZE;
+	}
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	struct SizeClass
+	{
+		FreeBlock* freeList = nullptr;
+		char* bumpNext = nullptr; // unused rest of the newest slab of this class
+		char* bumpEnd = nullptr;
+	};
+
+	static constexpr size_t CLASS_COUNT = MAX_BLOCK_SIZE / GRANULARITY;
+
+	static size_t classOf(const size_t bytes)
+	{
+		return bytes == 0 ? 0 : (bytes - 1) / GRANULARITY;
+	}
+
+private:
+	SizeClass sizeClasses[CLASS_COUNT];
+	std::vector<char*> slabs;
+	bool releasing;
+};
+
+/*
+*	Standard conforming allocator handle to a shared SlabPool. A default constructed
+*	PoolAllocator creates a new pool; copies and rebound copies (PoolAllocator<Node<V>> from
+*	PoolAllocator<V>) share it, and the pool lives until the last handle is gone.
+*	Pass one to a container to give that container its own pool, or the same one to several
+*	containers that should share a pool.
+*/
+template<typename T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = PoolAllocator<U>;
+	};
+
+public:
+	PoolAllocator()
+		:
+		pool(std::make_shared<SlabPool>())
+	{
+	}
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>& other) noexcept
+		:
+		pool(other.getPool())
+	{
+	}
+
+	T* allocate(const size_t count)
+	{
+		if (count == 1 && SlabPool::isPooled(sizeof(T), alignof(T)))
+		{
+			return static_cast<T*>(pool->allocate(sizeof(T)));
+		}
+		return std::allocator<T>().allocate(count);
+	}
+
+	void deallocate(T* pointer, const size_t count)
+	{
+		if (count == 1 && SlabPool::isPooled(sizeof(T), alignof(T)))
+		{
+			pool->deallocate(pointer, sizeof(T));
+			return;
+		}
+		std::allocator<T>().deallocate(pointer, count);
+	}
+
+	const std::shared_ptr<SlabPool>& getPool() const
+	{
+		return pool;
+	}
+
+	template<typename U>
+	bool operator==(const PoolAllocator<U>& other) const
+	{
+		return pool == other.getPool();
+	}
+
+	template<typename U>
+	bool operator!=(const PoolAllocator<U>& other) const
+	{
+		return pool != other.getPool();
+	}
+
+private:
+	std::shared_ptr<SlabPool> pool;
+};
+
+template<typename Allocator>
+struct IsPoolAllocator : std::false_type
+{
+};
+
+template<typename T>
+struct IsPoolAllocator<PoolAllocator<T>> : std::true_type
+{
+};
+
+/*
+*	True when a container that is being destroyed may drop its nodes without visiting them: the
+*	nodes need no destructor call and allocator is a PoolAllocator whose slabs are freed in bulk
+*	right after, because allocator is the last handle to the pool or the pool is being released.
+*/
+template<typename Node, typename Allocator>
+bool poolFreesInBulk(const Allocator& allocator)
+{
+	if constexpr (IsPoolAllocator<Allocator>::value && std::is_trivially_destructible<Node>::value)
+	{
+		return allocator.getPool().use_count() == 1 || allocator.getPool()->isReleasing();
+	}
+	else
+	{
+		return false;
+	}
+}
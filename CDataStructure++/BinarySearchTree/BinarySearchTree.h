@@ -1,16 +1,228 @@
 #pragma once
 
 #include <iostream>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "BinarySearchTreeNode.h"
+#include "SortedBuild.h"
+#include "../Allocator/PoolAllocator.h"
 
-template<typename T>
+// True when Compare declares is_transparent, i.e. it can compare T with other key types
+template<typename Compare, typename = void>
+struct IsTransparentCompare : std::false_type
+{
+};
+
+template<typename Compare>
+struct IsTransparentCompare<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type
+{
+};
+
+// The iterators [first, last) of a tree as something a range-based for can walk, see range(lo, hi)
+template<typename Iterator>
+class TreeRange
+{
+public:
+	TreeRange(Iterator first, Iterator last)
+		:
+		first(std::move(first)),
+		last(std::move(last))
+	{
+	}
+
+	Iterator begin() const
+	{
+		return first;
+	}
+
+	Iterator end() const
+	{
+		return last;
+	}
+
+	bool empty() const
+	{
+		return first == last;
+	}
+
+private:
+	Iterator first;
+	Iterator last;
+};
+
+/*
+*	Unbalanced binary search tree ordered by Compare. find, contains, lower_bound, upper_bound,
+*	equal_range and range descend by comparison, O(height) and without recursion; DFS visits the
+*	whole tree. With a transparent Compare (the default std::less<> is one) all of them accept any key
+*	comparable to T, e.g. a const char* or std::string_view for a tree of std::string, without
+*	building a temporary T.
+*	build_from_sorted loads sorted input in O(n) into a balanced tree, which insertNode would
+*	turn into a list.
+*	Nodes are allocated with Allocator (rebound to BinarySearchTreeNode<T>), e.g. a PoolAllocator.
+*/
+template<typename T, typename Compare = std::less<>, typename Allocator = std::allocator<T>>
 class BinarySearchTree
 {
+private:
+	// T itself, or any key type if Compare is transparent
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, T>::value || IsTransparentCompare<Compare>::value>::type;
+
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<BinarySearchTreeNode<T>>;
+	using NodeAllocatorTraits = std::allocator_traits<NodeAllocator>;
+
+public:
+	/*
+	*	Forward in-order iterator. The nodes have no parent pointer, so the iterator keeps the path
+	*	of nodes still to be visited: the current node on top, below it every ancestor whose own
+	*	value comes later. ++ is amortized O(1). The first INLINE_DEPTH entries of the path live in
+	*	the iterator itself, only a degenerate tree deeper than that makes it allocate.
+	*	Values are the keys of the tree, so they are read-only (same as std::set).
+	*/
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+	public:
+		Iterator()
+			:
+			depth(0)
+		{
+		}
+
+		Iterator(const Iterator& other)
+			:
+			deepPath(other.deepPath),
+			depth(other.depth)
+		{
+			copyInlinePath(other);
+		}
+
+		Iterator& operator=(const Iterator& other)
+		{
+			deepPath = other.deepPath;
+			depth = other.depth;
+			copyInlinePath(other);
+			return *this;
+		}
+
+		reference operator*() const
+		{
+			return top()->getData();
+		}
+
+		pointer operator->() const
+		{
+			return &top()->getData();
+		}
+
+		Iterator& operator++()
+		{
+			BinarySearchTreeNode<T>* currNode = top();
+			pop();
+			pushLeftPath(currNode->getRight());
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		// the node the iterator points to, nullptr for end()
+		BinarySearchTreeNode<T>* getNode() const
+		{
+			return depth > 0 ? top() : nullptr;
+		}
+
+		friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+		{
+			return lhs.getNode() == rhs.getNode();
+		}
+
+		friend bool operator!=(const Iterator& lhs, const Iterator& rhs)
+		{
+			return lhs.getNode() != rhs.getNode();
+		}
+
+	private:
+		friend class BinarySearchTree;
+
+		void push(BinarySearchTreeNode<T>* node)
+		{
+			if (depth < INLINE_DEPTH)
+			{
+				inlinePath[depth] = node;
+			}
+			else
+			{
+				deepPath.push_back(node);
+			}
+			++depth;
+		}
+
+		void pop()
+		{
+			if (depth > INLINE_DEPTH)
+			{
+				deepPath.pop_back();
+			}
+			--depth;
+		}
+
+		BinarySearchTreeNode<T>* top() const
+		{
+			return depth > INLINE_DEPTH ? deepPath.back() : inlinePath[depth - 1];
+		}
+
+		// node and all of its left descendants, the smallest value ends up on top
+		void pushLeftPath(BinarySearchTreeNode<T>* node)
+		{
+			for (; node != nullptr; node = node->getLeft())
+			{
+				push(node);
+			}
+		}
+
+		// only the used part of the inline path is copied
+		void copyInlinePath(const Iterator& other)
+		{
+			const size_t inlineDepth = depth < INLINE_DEPTH ? depth : INLINE_DEPTH;
+			for (size_t i = 0; i < inlineDepth; ++i)
+			{
+				inlinePath[i] = other.inlinePath[i];
+			}
+		}
+
+	private:
+		static constexpr size_t INLINE_DEPTH = 64;
+
+		BinarySearchTreeNode<T>* inlinePath[INLINE_DEPTH];
+		std::vector<BinarySearchTreeNode<T>*> deepPath; // entries past INLINE_DEPTH
+		size_t depth;
+	};
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+
 public:
-	BinarySearchTree()
+	explicit BinarySearchTree(const Allocator& allocator = Allocator())
 		:
-		root(nullptr)
+		root(nullptr),
+		nodeAllocator(allocator)
 	{
 	}
 	
@@ -20,19 +232,26 @@ public:
 	//{
 	//}
 
-	BinarySearchTree(const T& data)
+	BinarySearchTree(const T& data, const Allocator& allocator = Allocator())
 		:
-		root(new BinarySearchTreeNode<T>(data))
+		root(nullptr),
+		nodeAllocator(allocator)
 	{
+		root = createNode(data);
 	}
 
 	// Delete constructors which may cause headache and bugs
-	BinarySearchTree(const BinarySearchTree<T>&) = delete;
-	BinarySearchTree(BinarySearchTree<T>&&) = delete;
+	BinarySearchTree(const BinarySearchTree&) = delete;
+	BinarySearchTree(BinarySearchTree&&) = delete;
 
 	~BinarySearchTree()
 	{
-		cleanUpTree(root);
+		// with a pool of its own the slabs are freed wholesale, no need to visit every node
+		if (!poolFreesInBulk<BinarySearchTreeNode<T>>(nodeAllocator))
+		{
+			cleanUpTree(root);
+		}
+		releaseNodeBlocks();
 	}
 
 	void printTree(BinarySearchTreeNode<T>* node = nullptr)
@@ -69,11 +288,11 @@ public:
 			return;
 		}
 
-		if (data < currNode->getData())
+		if (comp(data, currNode->getData()))
 		{
 			return removeNode(data, currNode, currNode->getLeft());
 		} 
-		else if (data > currNode->getData())
+		else if (comp(currNode->getData(), data))
 		{
 			return removeNode(data, currNode, currNode->getRight());
 		}
@@ -97,18 +316,18 @@ public:
 			{
 				if (!currNode->hasLeft() && !currNode->hasRight())
 				{
-					delete root;
+					destroyNode(root);
 					root = nullptr;
 				}
 				else if (!currNode->hasRight() && currNode->hasLeft())
 				{
 					root = currNode->getLeft();
-					delete currNode;
+					destroyNode(currNode);
 				}
 				else if (currNode->hasRight() && !currNode->hasLeft())
 				{
 					root = currNode->getRight();
-					delete currNode;
+					destroyNode(currNode);
 				}
 				else
 				{
@@ -120,7 +339,7 @@ public:
 					{
 						nodeSuccessor->setLeft(root->getLeft());
 						root = nodeSuccessor;
-						delete currNode;
+						destroyNode(currNode);
 					}
 					else // successor node is somewhere in the tree
 					{
@@ -128,7 +347,7 @@ public:
 						nodeSuccessor->setLeft(root->getLeft());
 						nodeSuccessor->setRight(root->getRight());
 						root = nodeSuccessor;
-						delete currNode;
+						destroyNode(currNode);
 					}
 				}
 			}
@@ -137,17 +356,17 @@ public:
 				if (!currNode->hasLeft() && !currNode->hasRight())
 				{
 					setChildFromParent(parentNode, currNode, nullptr);
-					delete currNode;
+					destroyNode(currNode);
 				}
 				else if (!currNode->hasRight() && currNode->hasLeft())
 				{
 					setChildFromParent(parentNode, currNode, currNode->getLeft());
-					delete currNode;
+					destroyNode(currNode);
 				}
 				else if (currNode->hasRight() && !currNode->hasLeft())
 				{
 					setChildFromParent(parentNode, currNode, currNode->getRight());
-					delete currNode;
+					destroyNode(currNode);
 				}
 				else
 				{
@@ -159,7 +378,7 @@ public:
 					{
 						nodeSuccessor->setLeft(currNode->getLeft());
 						setChildFromParent(parentNode, currNode, nodeSuccessor);
-						delete currNode;
+						destroyNode(currNode);
 					}
 					else
 					{
@@ -167,7 +386,7 @@ public:
 						nodeSuccessor->setLeft(currNode->getLeft());
 						nodeSuccessor->setRight(currNode->getRight());
 						setChildFromParent(parentNode, currNode, nodeSuccessor);
-						delete currNode;
+						destroyNode(currNode);
 					}
 				}
 			}
@@ -186,14 +405,14 @@ public:
 		// if root is not pointing to a node yet, then just add the toAddNode as root.
 		if (root == nullptr)
 		{
-			root = new BinarySearchTreeNode<T>(data);
+			root = createNode(data);
 		}
 		else
 		{
 			BinarySearchTreeNode<T>* currNode = root;
 			while (currNode != nullptr)
 			{
-				if (data < currNode->getData())
+				if (comp(data, currNode->getData()))
 				{
 					if (currNode->hasLeft())
 					{
@@ -201,11 +420,11 @@ public:
 					}
 					else
 					{
-						currNode->setLeft(new BinarySearchTreeNode<T>(data));
+						currNode->setLeft(createNode(data));
 						return;
 					}						
 				}
-				else if (data > currNode->getData())
+				else if (comp(currNode->getData(), data))
 				{
 					if (currNode->hasRight())
 					{
@@ -213,7 +432,7 @@ public:
 					}
 					else
 					{
-						currNode->setRight(new BinarySearchTreeNode<T>(data));
+						currNode->setRight(createNode(data));
 						return;
 					}
 				}
@@ -226,37 +445,325 @@ public:
 		}
 	}
 
-	BinarySearchTreeNode<T>* DFS(const T& data, BinarySearchTreeNode<T>* currRoot)
+	/*
+	*	Replaces the contents of the tree with the values of the sorted range [first, last) in O(n)
+	*	and without comparing against the tree: the nodes come from one contiguous block, laid out
+	*	in sorted order, and are linked bottom-up into a perfectly balanced tree. Equal neighbours
+	*	are kept once, like insertNode does. An unsorted range throws std::invalid_argument before
+	*	the tree is touched; if copying a value throws, the tree is left empty.
+	*	Removed nodes of the block are destroyed, but the block is only freed as a whole when the
+	*	tree is rebuilt or destroyed.
+	*/
+	template<typename ForwardIt>
+	void build_from_sorted(ForwardIt first, const ForwardIt last)
+	{
+		const size_t count = tree_detail::countSortedDistinct(first, last, comp);
+		clearTree();
+		if (count == 0)
+		{
+			return;
+		}
+
+		// called once per node in sorted order, skips the equal neighbours of the value it returns
+		const auto nextValue = [&first, &last, this](size_t) -> const T& {
+			ForwardIt current = first;
+			for (++first; first != last && !comp(*current, *first); ++first)
+			{
+			}
+			return *current;
+		};
+		NodeBuilder<decltype(nextValue)> builder{ *this, allocateNodeBlock(count), nextValue };
+		buildFromBlock(builder, count, 1);
+	}
+
+	/*
+	*	build_from_sorted, with the left and right halves of the tree built on separate threads
+	*	(threadCount 0 means std::thread::hardware_concurrency()). Every node is constructed
+	*	straight from its position in [first, last), so input with equal neighbours is built by
+	*	build_from_sorted instead, as are inputs too small to be worth starting threads for.
+	*/
+	template<typename RandomIt>
+	void parallel_build_from_sorted(RandomIt first, const RandomIt last, size_t threadCount = 0)
 	{
+		static constexpr size_t MIN_NODES_PER_THREAD = 16384;
+
+		const size_t count = tree_detail::countSortedDistinct(first, last, comp);
+		if (count != static_cast<size_t>(last - first))
+		{
+			build_from_sorted(first, last);
+			return;
+		}
+
+		if (threadCount == 0)
+		{
+			threadCount = std::thread::hardware_concurrency();
+		}
+		if (threadCount > count / MIN_NODES_PER_THREAD)
+		{
+			threadCount = count / MIN_NODES_PER_THREAD;
+		}
+
+		clearTree();
+		if (count == 0)
+		{
+			return;
+		}
+
+		const auto valueAt = [first](const size_t index) -> const T& {
+			return first[index];
+		};
+		NodeBuilder<decltype(valueAt)> builder{ *this, allocateNodeBlock(count), valueAt };
+		buildFromBlock(builder, count, threadCount);
+	}
+
+	/*
+	*	Full pre-order traversal of the subtree below currRoot that doesn't use the ordering, for
+	*	callers that really want to visit every node. Iterative, so degenerate trees can't
+	*	overflow the stack. Lookups should use find.
+	*/
+	template<typename Key, typename = EnableLookup<Key>>
+	BinarySearchTreeNode<T>* DFS(const Key& data, BinarySearchTreeNode<T>* currRoot)
+	{
+		std::vector<BinarySearchTreeNode<T>*> pending;
 		if (currRoot != nullptr)
 		{
-			if (currRoot->getData() == data)
-				return currRoot;
+			pending.push_back(currRoot);
+		}
+
+		while (!pending.empty())
+		{
+			BinarySearchTreeNode<T>* currNode = pending.back();
+			pending.pop_back();
+			if (isEquivalent(currNode->getData(), data))
+				return currNode;
 
-			if (currRoot->hasLeft())
+			// right first, so the left subtree is visited first
+			if (currNode->hasRight())
+				pending.push_back(currNode->getRight());
+			if (currNode->hasLeft())
+				pending.push_back(currNode->getLeft());
+		}
+
+		return nullptr;
+	}
+
+	BinarySearchTreeNode<T>* DFS(const T& data)
+	{
+		return DFS<T>(data, root);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	BinarySearchTreeNode<T>* DFS(const Key& data)
+	{
+		return DFS<Key>(data, root);
+	}
+
+	// Node equivalent to data, nullptr if there is none
+	BinarySearchTreeNode<T>* find(const T& data)
+	{
+		return find<T>(data);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	BinarySearchTreeNode<T>* find(const Key& data)
+	{
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (comp(data, currNode->getData()))
 			{
-				auto foundLeft = DFS(data, currRoot->getLeft());
-				if (foundLeft)
-					return foundLeft;
+				currNode = currNode->getLeft();
 			}
+			else if (comp(currNode->getData(), data))
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				return currNode;
+			}
+		}
+		return nullptr;
+	}
+
+	bool contains(const T& data)
+	{
+		return find<T>(data) != nullptr;
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool contains(const Key& data)
+	{
+		return find<Key>(data) != nullptr;
+	}
 
-			if (currRoot->getRight())
+	// Node with the smallest value not less than data, nullptr if all values are less
+	BinarySearchTreeNode<T>* lower_bound(const T& data)
+	{
+		return lower_bound<T>(data);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	BinarySearchTreeNode<T>* lower_bound(const Key& data)
+	{
+		BinarySearchTreeNode<T>* bound = nullptr;
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (comp(currNode->getData(), data))
+			{
+				currNode = currNode->getRight();
+			}
+			else
 			{
-				auto foundRight = DFS(data, currRoot->getRight());
-				if (foundRight)
-					return foundRight;
+				bound = currNode;
+				currNode = currNode->getLeft();
 			}
 		}
+		return bound;
+	}
 
-		return nullptr;
+	// Node with the smallest value greater than data, nullptr if there is none
+	BinarySearchTreeNode<T>* upper_bound(const T& data)
+	{
+		return upper_bound<T>(data);
 	}
 
-	BinarySearchTreeNode<T>* DFS(const T& data)
+	template<typename Key, typename = EnableLookup<Key>>
+	BinarySearchTreeNode<T>* upper_bound(const Key& data)
+	{
+		BinarySearchTreeNode<T>* bound = nullptr;
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (comp(data, currNode->getData()))
+			{
+				bound = currNode;
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				currNode = currNode->getRight();
+			}
+		}
+		return bound;
+	}
+
+	/*
+	*	(lower_bound(data), upper_bound(data)) in a single descent: both bounds share the path
+	*	down to the node equivalent to data. Values are unique, so the range holds at most that
+	*	one node; first == second means data is not in the tree.
+	*/
+	std::pair<BinarySearchTreeNode<T>*, BinarySearchTreeNode<T>*> equal_range(const T& data)
 	{
-		return DFS(data, root);
+		return equal_range<T>(data);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	std::pair<BinarySearchTreeNode<T>*, BinarySearchTreeNode<T>*> equal_range(const Key& data)
+	{
+		BinarySearchTreeNode<T>* upperBound = nullptr;
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (comp(data, currNode->getData()))
+			{
+				upperBound = currNode;
+				currNode = currNode->getLeft();
+			}
+			else if (comp(currNode->getData(), data))
+			{
+				currNode = currNode->getRight();
+			}
+			else
+			{
+				// the successor is the leftmost node of the right subtree, or the last left turn above
+				BinarySearchTreeNode<T>* successor = currNode->getRight();
+				if (successor == nullptr)
+				{
+					return std::make_pair(currNode, upperBound);
+				}
+				while (successor->hasLeft())
+				{
+					successor = successor->getLeft();
+				}
+				return std::make_pair(currNode, successor);
+			}
+		}
+		return std::make_pair(upperBound, upperBound);
+	}
+
+	iterator begin()
+	{
+		Iterator first;
+		first.pushLeftPath(root);
+		return first;
+	}
+
+	iterator end()
+	{
+		return Iterator();
+	}
+
+	const_iterator cbegin()
+	{
+		return begin();
+	}
+
+	const_iterator cend()
+	{
+		return end();
+	}
+
+	// All values in [lo, hi] in order, e.g. for (const T& value : tree.range(lo, hi))
+	TreeRange<iterator> range(const T& lo, const T& hi)
+	{
+		return range<T, T>(lo, hi);
+	}
+
+	template<typename LoKey, typename HiKey, typename = EnableLookup<LoKey>, typename = EnableLookup<HiKey>>
+	TreeRange<iterator> range(const LoKey& lo, const HiKey& hi)
+	{
+		// only compared with values of the tree, lo and hi may be of different key types
+		Iterator first = boundIterator(lo, false);
+		if (first == end() || comp(hi, *first))
+		{
+			return TreeRange<iterator>(end(), end());
+		}
+		return TreeRange<iterator>(first, boundIterator(hi, true));
 	}
 
 private:
+	/*
+	*	Iterator to lower_bound(data), or to upper_bound(data) if upper. The descent pushes every
+	*	node it leaves to the left, which is exactly the path begin() + ++ would have built.
+	*/
+	template<typename Key>
+	Iterator boundIterator(const Key& data, const bool upper)
+	{
+		Iterator bound;
+		BinarySearchTreeNode<T>* currNode = root;
+		while (currNode != nullptr)
+		{
+			if (upper ? comp(data, currNode->getData()) : !comp(currNode->getData(), data))
+			{
+				bound.push(currNode);
+				currNode = currNode->getLeft();
+			}
+			else
+			{
+				currNode = currNode->getRight();
+			}
+		}
+		return bound;
+	}
+
+	template<typename Key>
+	bool isEquivalent(const T& nodeData, const Key& data) const
+	{
+		return !comp(nodeData, data) && !comp(data, nodeData);
+	}
+
 	// from https://stackoverflow.com/questions/36802354/print-binary-tree-in-a-pretty-way-using-c
 	void printTree(const std::string& prefix, BinarySearchTreeNode<T>* node, bool isLeft)
 	{
@@ -313,28 +820,145 @@ private:
 		}
 	}
 	
-	void cleanUpTree(BinarySearchTreeNode<T>* currNode)
+	// Constructs the nodes of build_from_sorted in their block, see tree_detail::buildBalanced
+	template<typename ValueAt>
+	struct NodeBuilder
 	{
-		// Post-order traversal to delete and free up memory taken by each node.
-		// First the left three and right tree are visited and deleted first and then the current node is deleted so 
-		// that everything descendent node is deleted first before deleting the current node to not lose reference
-		// and cause memory leaks.
-		if (currNode != nullptr)
+		BinarySearchTree& tree;
+		BinarySearchTreeNode<T>* block;
+		ValueAt valueAt;
+
+		BinarySearchTreeNode<T>* construct(const size_t index, BinarySearchTreeNode<T>* left)
 		{
-			if (currNode->hasLeft())
+			NodeAllocatorTraits::construct(tree.nodeAllocator, block + index, valueAt(index), left);
+			return block + index;
+		}
+
+		void attachRight(BinarySearchTreeNode<T>* node, BinarySearchTreeNode<T>* right, size_t, size_t)
+		{
+			node->setRight(right);
+		}
+
+		void destroyRange(const size_t lo, const size_t hi)
+		{
+			for (size_t i = lo; i < hi; ++i)
 			{
-				cleanUpTree(currNode->getLeft());
+				NodeAllocatorTraits::destroy(tree.nodeAllocator, block + i);
 			}
+		}
+	};
 
-			if (currNode->hasRight())
+	template<typename Builder>
+	void buildFromBlock(Builder& builder, const size_t count, const size_t threadCount)
+	{
+		try
+		{
+			root = threadCount > 1
+				? tree_detail::buildBalancedParallel<BinarySearchTreeNode<T>>(0, count, threadCount, builder)
+				: tree_detail::buildBalanced<BinarySearchTreeNode<T>>(0, count, builder);
+		}
+		catch (...)
+		{
+			releaseNodeBlocks();
+			throw;
+		}
+	}
+
+	BinarySearchTreeNode<T>* allocateNodeBlock(const size_t count)
+	{
+		BinarySearchTreeNode<T>* block = NodeAllocatorTraits::allocate(nodeAllocator, count);
+		try
+		{
+			nodeBlocks.emplace_back(block, count);
+		}
+		catch (...)
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, block, count);
+			throw;
+		}
+		return block;
+	}
+
+	bool isBlockNode(const BinarySearchTreeNode<T>* node) const
+	{
+		const std::less<> before;
+		for (const auto& block : nodeBlocks)
+		{
+			if (!before(node, block.first) && before(node, block.first + block.second))
 			{
-				cleanUpTree(currNode->getRight());
+				return true;
 			}
+		}
+		return false;
+	}
+
+	void releaseNodeBlocks()
+	{
+		for (const auto& block : nodeBlocks)
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, block.first, block.second);
+		}
+		nodeBlocks.clear();
+	}
+
+	void clearTree()
+	{
+		cleanUpTree(root);
+		root = nullptr;
+		releaseNodeBlocks();
+	}
 
-			delete currNode;
+	BinarySearchTreeNode<T>* createNode(const T& data)
+	{
+		BinarySearchTreeNode<T>* node = NodeAllocatorTraits::allocate(nodeAllocator, 1);
+		try
+		{
+			NodeAllocatorTraits::construct(nodeAllocator, node, data);
+		}
+		catch (...)
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void destroyNode(BinarySearchTreeNode<T>* node)
+	{
+		NodeAllocatorTraits::destroy(nodeAllocator, node);
+		// nodes of a block are given back with their block
+		if (!isBlockNode(node))
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+		}
+	}
+
+	void cleanUpTree(BinarySearchTreeNode<T>* currNode)
+	{
+		// Without recursion, so degenerate trees can't overflow the stack: a node with a left
+		// child is rotated right (the left child comes up), a node without one is deleted and its
+		// right subtree is cleaned up next. Every node is rotated at most once per left child.
+		while (currNode != nullptr)
+		{
+			if (currNode->hasLeft())
+			{
+				BinarySearchTreeNode<T>* leftNode = currNode->getLeft();
+				currNode->setLeft(leftNode->getRight());
+				leftNode->setRight(currNode);
+				currNode = leftNode;
+			}
+			else
+			{
+				BinarySearchTreeNode<T>* rightNode = currNode->getRight();
+				destroyNode(currNode);
+				currNode = rightNode;
+			}
 		}
 	}
 
 private:
 	BinarySearchTreeNode<T>* root;
+	Compare comp;
+	NodeAllocator nodeAllocator;
+	std::vector<std::pair<BinarySearchTreeNode<T>*, size_t>> nodeBlocks; // blocks of build_from_sorted, freed as a whole
 };
\ No newline at end of file
@@ -16,14 +16,6 @@ public:
 	{
 	}
 
-	~BinarySearchTreeNode()
-	{
-		if (hasRight())
-			right = nullptr;
-		if (hasLeft())
-			left = nullptr;
-	}
-
 	BinarySearchTreeNode* getLeft()
 	{
 		return left;
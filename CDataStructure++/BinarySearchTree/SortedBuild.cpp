@@ -0,0 +1 @@
+#include <SortedBuild.h>
\ No newline at end of file
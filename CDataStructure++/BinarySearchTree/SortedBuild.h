@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace tree_detail
+{
+	// Root of the balanced tree over the in-order indices [lo, hi), the right half gets the extra node
+	inline size_t middleOf(const size_t lo, const size_t hi)
+	{
+		return lo + (hi - lo - 1) / 2;
+	}
+
+	// Height of the tree middleOf builds over count nodes
+	inline int heightOf(size_t count)
+	{
+		int height = 0;
+		for (; count != 0; count >>= 1)
+		{
+			++height;
+		}
+		return height;
+	}
+
+	/*
+	*	Runs left(threadCount / 2) on a new thread while the calling thread runs
+	*	right(threadCount - threadCount / 2), and returns what each of them threw. If no thread can
+	*	be started, left runs on the calling thread as well.
+	*/
+	template<typename Left, typename Right>
+	std::pair<std::exception_ptr, std::exception_ptr> forkJoin(const size_t threadCount, Left&& left, Right&& right)
+	{
+		std::exception_ptr leftError;
+		std::exception_ptr rightError;
+		const auto runLeft = [&]() {
+			try
+			{
+				left(threadCount / 2);
+			}
+			catch (...)
+			{
+				leftError = std::current_exception();
+			}
+		};
+
+		std::thread leftWorker;
+		try
+		{
+			leftWorker = std::thread(runLeft);
+		}
+		catch (...)
+		{
+			runLeft();
+		}
+
+		try
+		{
+			right(threadCount - threadCount / 2);
+		}
+		catch (...)
+		{
+			rightError = std::current_exception();
+		}
+
+		if (leftWorker.joinable())
+		{
+			leftWorker.join();
+		}
+		return std::make_pair(leftError, rightError);
+	}
+
+	/*
+	*	Number of distinct values in the sorted range [first, last), throws std::invalid_argument
+	*	if a value is less than the one before it.
+	*/
+	template<typename ForwardIt, typename Compare>
+	size_t countSortedDistinct(ForwardIt first, const ForwardIt last, const Compare& comp)
+	{
+		if (first == last)
+		{
+			return 0;
+		}
+
+		size_t distinct = 1;
+		ForwardIt previous = first;
+		for (++first; first != last; previous = first, ++first)
+		{
+			if (comp(*first, *previous))
+			{
+				throw std::invalid_argument("build_from_sorted: input is not sorted");
+			}
+			if (comp(*previous, *first))
+			{
+				++distinct;
+			}
+		}
+		return distinct;
+	}
+
+	/*
+	*	Builds the balanced tree over the in-order indices [lo, hi) bottom-up and returns its root.
+	*	Builder provides
+	*		Node* construct(size_t index, Node* left);	// node index with its finished left subtree
+	*		void attachRight(Node* node, Node* right, size_t leftCount, size_t rightCount);
+	*		void destroyRange(size_t lo, size_t hi);	// destroys the constructed nodes of [lo, hi)
+	*	construct is called for lo, lo + 1, ... in this order, so it may read the values from a
+	*	forward iterator. Either every node of [lo, hi) is constructed, or the ones that were are
+	*	destroyed again and the exception is rethrown.
+	*/
+	template<typename Node, typename Builder>
+	Node* buildBalanced(const size_t lo, const size_t hi, Builder& builder)
+	{
+		if (lo == hi)
+		{
+			return nullptr;
+		}
+
+		const size_t mid = middleOf(lo, hi);
+		Node* left = buildBalanced<Node>(lo, mid, builder);
+
+		Node* node = nullptr;
+		try
+		{
+			node = builder.construct(mid, left);
+		}
+		catch (...)
+		{
+			builder.destroyRange(lo, mid);
+			throw;
+		}
+
+		Node* right = nullptr;
+		try
+		{
+			right = buildBalanced<Node>(mid + 1, hi, builder);
+		}
+		catch (...)
+		{
+			builder.destroyRange(lo, mid + 1);
+			throw;
+		}
+
+		builder.attachRight(node, right, mid - lo, hi - mid - 1);
+		return node;
+	}
+
+	/*
+	*	Same tree as buildBalanced, but the left half is built on a new thread while the calling
+	*	thread builds the right half, recursively until every thread has a range of its own.
+	*	construct is called in no particular order and concurrently, the values have to come from
+	*	a random access range. If no thread can be started the half is built on the calling thread.
+	*/
+	template<typename Node, typename Builder>
+	Node* buildBalancedParallel(const size_t lo, const size_t hi, const size_t threadCount, Builder& builder)
+	{
+		if (threadCount <= 1 || hi - lo < 3)
+		{
+			return buildBalanced<Node>(lo, hi, builder);
+		}
+
+		const size_t mid = middleOf(lo, hi);
+		Node* left = nullptr;
+		Node* right = nullptr;
+		const auto errors = forkJoin(threadCount,
+			[&](const size_t threads) { left = buildBalancedParallel<Node>(lo, mid, threads, builder); },
+			[&](const size_t threads) { right = buildBalancedParallel<Node>(mid + 1, hi, threads, builder); });
+		const std::exception_ptr& leftError = errors.first;
+		const std::exception_ptr& rightError = errors.second;
+
+		if (leftError || rightError)
+		{
+			if (!leftError)
+			{
+				builder.destroyRange(lo, mid);
+			}
+			if (!rightError)
+			{
+				builder.destroyRange(mid + 1, hi);
+			}
+			std::rethrow_exception(leftError ? leftError : rightError);
+		}
+
+		Node* node = nullptr;
+		try
+		{
+			node = builder.construct(mid, left);
+		}
+		catch (...)
+		{
+			builder.destroyRange(lo, mid);
+			builder.destroyRange(mid + 1, hi);
+			throw;
+		}
+
+		builder.attachRight(node, right, mid - lo, hi - mid - 1);
+		return node;
+	}
+}
@@ -0,0 +1 @@
+#include <BlockedBloomFilter.h>
\ No newline at end of file
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <iostream>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include "../HashTable/HashPolicies.h"
+
+/*
+*	One cache line of filter bits. All bits of a key live in the same block, so a lookup touches
+*	exactly one cache line no matter how many hash functions are used.
+*/
+struct alignas(64) BloomBlock
+{
+	static constexpr size_t BITS = 512;
+	static constexpr size_t WORDS = BITS / 64;
+
+	uint64_t words[WORDS];
+};
+
+/*
+*	Cache-line blocked Bloom filter (Putze, Sanders, Singler: "Cache-, Hash- and Space-Efficient
+*	Bloom Filters"). The key hash picks a 512 bit block, a remix of it picks k bits inside that
+*	block. A "no" is always right, a "maybe" is wrong with about the configured false positive
+*	rate. Blocking costs a little accuracy compared to a classic Bloom filter for the same number
+*	of bits, but a miss is rejected with a single memory access.
+*
+*	It can sit in front of any container: insert every key that is put into the container and
+*	look keys up through find(key, lookup), which only calls lookup when the filter says maybe
+*	and counts how many of those were false positives.
+*	Bits can't be removed, so keys erased from the container keep passing the filter and show up
+*	as false positives. When that rate climbs, clear() and insert the remaining keys again.
+*/
+template<typename K, typename Hash = FastHash<K>>
+class BlockedBloomFilter
+{
+private:
+	// K itself, or any key type if Hash is transparent
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, K>::value || IsTransparentLookup<Hash, std::equal_to<>>::value>::type;
+
+	static constexpr unsigned MAX_HASH_COUNT = 16;
+
+public:
+	struct Stats
+	{
+		uint64_t queries = 0;
+		uint64_t rejected = 0;		 // answered by the filter alone
+		uint64_t falsePositives = 0; // passed the filter but not found by lookup
+
+		// Share of absent keys that got past the filter
+		double observedFalsePositiveRate() const
+		{
+			const uint64_t negatives = rejected + falsePositives;
+			return negatives == 0 ? 0.0 : static_cast<double>(falsePositives) / static_cast<double>(negatives);
+		}
+	};
+
+public:
+	/*
+	*	Sized for expectedEntries keys at the given false positive rate: -ln(rate) / ln(2)^2 bits
+	*	and ln(2) * bits hash functions per key.
+	*/
+	BlockedBloomFilter(const size_t expectedEntries, const double falsePositiveRate = 0.01)
+		:
+		hashCount(1),
+		entryCount(0)
+	{
+		const double rate = falsePositiveRate > 0.0 && falsePositiveRate < 1.0 ? falsePositiveRate : 0.01;
+		const double ln2 = std::log(2.0);
+		const double bitsPerKey = -std::log(rate) / (ln2 * ln2);
+		const double bits = bitsPerKey * static_cast<double>(expectedEntries > 0 ? expectedEntries : 1);
+
+		blocks.resize(static_cast<size_t>(std::ceil(bits / BloomBlock::BITS)) + 1);
+		clear();
+
+		const long roundedHashCount = std::lround(bitsPerKey * ln2);
+		hashCount = static_cast<unsigned>(roundedHashCount < 1 ? 1 : (roundedHashCount > MAX_HASH_COUNT ? MAX_HASH_COUNT : roundedHashCount));
+	}
+
+	// Delete constructors which may cause headache and bugs
+	BlockedBloomFilter(const BlockedBloomFilter&) = delete;
+	BlockedBloomFilter(BlockedBloomFilter&&) = delete;
+
+	void insert(const K& key)
+	{
+		insertHash(Hash{}(key));
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	void insert(const Key& key)
+	{
+		insertHash(Hash{}(key));
+	}
+
+	// For callers that already computed Hash{}(key)
+	void insertHash(const size_t hash)
+	{
+		BloomBlock& block = blocks[blockOf(hash)];
+		BitPositions positions(hash);
+		for (unsigned i = 0; i < hashCount; ++i)
+		{
+			const unsigned bit = positions.next();
+			block.words[bit / 64] |= uint64_t(1) << (bit % 64);
+		}
+		++entryCount;
+	}
+
+	// False means key was never inserted, true means it probably was
+	bool mayContain(const K& key) const
+	{
+		return mayContainHash(Hash{}(key));
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool mayContain(const Key& key) const
+	{
+		return mayContainHash(Hash{}(key));
+	}
+
+	bool mayContainHash(const size_t hash) const
+	{
+		const BloomBlock& block = blocks[blockOf(hash)];
+		BitPositions positions(hash);
+		for (unsigned i = 0; i < hashCount; ++i)
+		{
+			const unsigned bit = positions.next();
+			if ((block.words[bit / 64] & (uint64_t(1) << (bit % 64))) == 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	*	Filtered lookup: returns nullptr right away when the filter rules key out, otherwise
+	*	lookup(key), which must return a pointer (nullptr when key is absent). Counts queries,
+	*	rejections and false positives in getStats.
+	*/
+	template<typename Key, typename Lookup>
+	auto find(const Key& key, Lookup lookup) -> decltype(lookup(key))
+	{
+		++stats.queries;
+		if (!mayContain(key))
+		{
+			++stats.rejected;
+			return nullptr;
+		}
+
+		auto result = lookup(key);
+		if (result == nullptr)
+		{
+			++stats.falsePositives;
+		}
+		return result;
+	}
+
+	void clear()
+	{
+		for (BloomBlock& block : blocks)
+		{
+			for (uint64_t& word : block.words)
+			{
+				word = 0;
+			}
+		}
+		entryCount = 0;
+	}
+
+	/*
+	*	False positive rate expected from the bits set so far: the chance that all k probed bits
+	*	of a random absent key are set, averaged over the blocks it could land in.
+	*/
+	double estimatedFalsePositiveRate() const
+	{
+		double sum = 0.0;
+		for (const BloomBlock& block : blocks)
+		{
+			size_t setBits = 0;
+			for (const uint64_t word : block.words)
+			{
+				setBits += std::bitset<64>(word).count();
+			}
+			sum += std::pow(static_cast<double>(setBits) / BloomBlock::BITS, static_cast<double>(hashCount));
+		}
+		return sum / static_cast<double>(blocks.size());
+	}
+
+	// Number of insert calls since the last clear, duplicates included
+	size_t size() const
+	{
+		return entryCount;
+	}
+
+	size_t getBitCount() const
+	{
+		return blocks.size() * BloomBlock::BITS;
+	}
+
+	unsigned getHashCount() const
+	{
+		return hashCount;
+	}
+
+	const Stats& getStats() const
+	{
+		return stats;
+	}
+
+	void resetStats()
+	{
+		stats = Stats();
+	}
+
+	void printStats() const
+	{
+		std::cout << "Entries: " << entryCount << "\t" << "Bits: " << getBitCount() << "\t" << "Hashes: " << hashCount << "\t"
+			<< "Estimated FPR: " << estimatedFalsePositiveRate() * 100.0 << "%" << "\n";
+		std::cout << "Queries: " << stats.queries << "\t" << "Rejected: " << stats.rejected << "\t" << "False positives: " << stats.falsePositives << "\t"
+			<< "Observed FPR: " << stats.observedFalsePositiveRate() * 100.0 << "%" << std::endl;
+	}
+
+private:
+	/*
+	*	Bit indices inside a block by double hashing a remix of the key hash, which is independent
+	*	from the high bits that picked the block.
+	*/
+	class BitPositions
+	{
+	public:
+		explicit BitPositions(const size_t hash)
+		{
+			const uint64_t mixed = hashMix(static_cast<uint64_t>(hash) ^ hash_detail::SECRET2, hash_detail::SECRET3);
+			current = static_cast<uint32_t>(mixed);
+			step = static_cast<uint32_t>(mixed >> 32) | 1;
+		}
+
+		// top 9 bits of a 32 bit value index the 512 bits
+		unsigned next()
+		{
+			const unsigned bit = current >> 23;
+			current += step;
+			return bit;
+		}
+
+	private:
+		uint32_t current;
+		uint32_t step;
+	};
+
+	size_t blockOf(const size_t hash) const
+	{
+		return RangeReducer::reduce(hash, blocks.size());
+	}
+
+private:
+	std::vector<BloomBlock> blocks;
+	unsigned hashCount;
+	size_t entryCount;
+	Stats stats;
+};
@@ -0,0 +1 @@
+#include <BoundedCache.h>
\ No newline at end of file
@@ -0,0 +1,497 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <utility>
+#include "FlatHashTable.h"
+#include "HashPolicies.h"
+#include "../LinkedList/IntrusiveList.h"
+
+/*
+*	One cached key/value pair. It is linked into the list of its eviction policy through the hook
+*	it derives from, so touching or evicting an entry never allocates.
+*/
+template<typename K, typename V>
+struct CacheEntry : public IntrusiveListHook<>
+{
+	CacheEntry(const K& key, const V& value, const size_t hash, const size_t bytes)
+		:
+		key(key),
+		value(value),
+		hash(hash),
+		bytes(bytes),
+		frequency(0),
+		queue(0)
+	{
+	}
+
+	K key;
+	V value;
+	size_t hash;	   // hash of key, the S3-FIFO ghost queue only remembers this
+	size_t bytes;	   // what the entry counts against the byte bound
+	uint8_t frequency; // recent hits, saturating (CLOCK reference bit, S3-FIFO counter)
+	uint8_t queue;	   // which queue of the policy the entry is in
+};
+
+/*
+*	Default size of an entry for the byte bound: the entry itself plus the characters of string
+*	keys/values. Pass a custom Sizer to BoundedCache for other heap owning types.
+*/
+template<typename K, typename V>
+struct CacheEntrySize
+{
+	size_t operator()(const K& key, const V& value) const
+	{
+		return sizeof(CacheEntry<K, V>) + dynamicSize(key) + dynamicSize(value);
+	}
+
+private:
+	template<typename T>
+	static size_t dynamicSize(const T&)
+	{
+		return 0;
+	}
+
+	static size_t dynamicSize(const std::string& str)
+	{
+		return str.size();
+	}
+};
+
+/*
+*	Eviction policies of BoundedCache. Each one keeps the resident entries in its own order and
+*	gets told about every insert, hit and erase:
+*		onInsert(entry) - entry was just added
+*		onHit(entry)	- entry was read or overwritten
+*		onErase(entry)	- entry leaves the cache (evicted or erased), unlink it
+*		victim()		- entry to evict next, only called when the cache isn't empty
+*/
+
+// Least recently used: a hit moves the entry to the front, the back is evicted.
+template<typename Entry>
+class LruPolicy
+{
+public:
+	void onInsert(Entry& entry)
+	{
+		order.pushFront(entry);
+	}
+
+	void onHit(Entry& entry)
+	{
+		order.moveToFront(entry);
+	}
+
+	void onErase(Entry& entry)
+	{
+		order.remove(entry);
+	}
+
+	Entry* victim()
+	{
+		return order.back();
+	}
+
+private:
+	IntrusiveList<Entry> order;
+};
+
+/*
+*	CLOCK: an approximation of LRU where a hit only sets a reference bit instead of relinking.
+*	The hand sweeps over the entries in insertion order, clears set bits and evicts the first
+*	entry whose bit is already clear.
+*/
+template<typename Entry>
+class ClockPolicy
+{
+public:
+	ClockPolicy()
+		:
+		hand(nullptr)
+	{
+	}
+
+	void onInsert(Entry& entry)
+	{
+		// new entries go right behind the hand, so they get a full sweep before eviction
+		entry.frequency = 0;
+		if (hand == nullptr)
+		{
+			ring.pushBack(entry);
+			hand = &entry;
+		}
+		else
+		{
+			ring.insertBefore(*hand, entry);
+		}
+	}
+
+	void onHit(Entry& entry)
+	{
+		entry.frequency = 1;
+	}
+
+	void onErase(Entry& entry)
+	{
+		if (hand == &entry)
+		{
+			advance();
+			hand = hand == &entry ? nullptr : hand;
+		}
+		ring.remove(entry);
+	}
+
+	Entry* victim()
+	{
+		while (hand->frequency != 0)
+		{
+			hand->frequency = 0;
+			advance();
+		}
+		return hand;
+	}
+
+private:
+	void advance()
+	{
+		hand = ring.next(*hand);
+		if (hand == nullptr)
+		{
+			hand = ring.front();
+		}
+	}
+
+	IntrusiveList<Entry> ring;
+	Entry* hand;
+};
+
+/*
+*	S3-FIFO (Yang et al., SOSP'23): scan resistant, FIFO queues only.
+*	New entries go to a small queue (~10% of the entries). An entry that reaches the end of the
+*	small queue without a hit is evicted right away and its hash is remembered in a ghost queue;
+*	one that was hit moves on to the main queue. Keys found in the ghost queue skip the small
+*	queue. The main queue evicts like CLOCK with a 2 bit counter. A one-off scan therefore only
+*	cycles through the small queue and doesn't flush the frequently used entries.
+*/
+template<typename Entry>
+class S3FifoPolicy
+{
+public:
+	void onInsert(Entry& entry)
+	{
+		entry.frequency = 0;
+		size_t* ghostCount = ghostCounts.find(entry.hash);
+		if (ghostCount != nullptr)
+		{
+			forgetGhost(entry.hash, *ghostCount);
+			entry.queue = MAIN;
+			mainQueue.pushFront(entry);
+		}
+		else
+		{
+			entry.queue = SMALL;
+			smallQueue.pushFront(entry);
+		}
+	}
+
+	void onHit(Entry& entry)
+	{
+		entry.frequency = entry.frequency < MAX_FREQUENCY ? entry.frequency + 1 : MAX_FREQUENCY;
+	}
+
+	void onErase(Entry& entry)
+	{
+		(entry.queue == SMALL ? smallQueue : mainQueue).remove(entry);
+	}
+
+	Entry* victim()
+	{
+		while (true)
+		{
+			const size_t resident = smallQueue.getSize() + mainQueue.getSize();
+			if (!smallQueue.empty() && (smallQueue.getSize() * SMALL_QUEUE_SHARE >= resident || mainQueue.empty()))
+			{
+				Entry* oldest = smallQueue.back();
+				if (oldest->frequency == 0)
+				{
+					rememberGhost(oldest->hash, resident);
+					return oldest;
+				}
+
+				smallQueue.remove(*oldest);
+				oldest->frequency = 0;
+				oldest->queue = MAIN;
+				mainQueue.pushFront(*oldest);
+			}
+			else
+			{
+				Entry* oldest = mainQueue.back();
+				if (oldest->frequency == 0)
+				{
+					return oldest;
+				}
+
+				--oldest->frequency;
+				mainQueue.moveToFront(*oldest);
+			}
+		}
+	}
+
+private:
+	static constexpr uint8_t SMALL = 0;
+	static constexpr uint8_t MAIN = 1;
+	static constexpr uint8_t MAX_FREQUENCY = 3;
+	static constexpr size_t SMALL_QUEUE_SHARE = 10; // small queue holds 1/10 of the entries
+
+	// The ghost queue holds as many hashes as there are resident entries
+	void rememberGhost(const size_t hash, const size_t resident)
+	{
+		ghostQueue.push_back(hash);
+		size_t* ghostCount = ghostCounts.find(hash);
+		if (ghostCount != nullptr)
+		{
+			++*ghostCount;
+		}
+		else
+		{
+			ghostCounts.insert(hash, 1);
+		}
+
+		while (ghostQueue.size() > resident)
+		{
+			const size_t oldest = ghostQueue.front();
+			ghostQueue.pop_front();
+			size_t* oldestCount = ghostCounts.find(oldest);
+			if (oldestCount != nullptr)
+			{
+				forgetGhost(oldest, *oldestCount);
+			}
+		}
+	}
+
+	// Only the count is updated, the hash itself stays in ghostQueue until it falls out. Ghost
+	// membership is approximate anyway: only hashes are kept, not keys.
+	void forgetGhost(const size_t hash, size_t& ghostCount)
+	{
+		if (--ghostCount == 0)
+		{
+			ghostCounts.erase(hash);
+		}
+	}
+
+	IntrusiveList<Entry> smallQueue;
+	IntrusiveList<Entry> mainQueue;
+	std::deque<size_t> ghostQueue;
+	FlatHashTable<size_t, size_t> ghostCounts; // hash -> occurrences in ghostQueue
+};
+
+/*
+*	Cache front for a slower store: a FlatHashTable from key to entry, bounded by a maximum
+*	entry count and a maximum byte size (as measured by Sizer). Whenever a put would exceed
+*	either bound, entries are evicted in the order chosen by Policy (LruPolicy, ClockPolicy or
+*	S3FifoPolicy).
+*	Pointers returned by get stay valid until the entry is evicted or erased.
+*/
+template<
+	typename K,
+	typename V,
+	template<typename> class Policy = LruPolicy,
+	typename Hash = FastHash<K>,
+	typename Sizer = CacheEntrySize<K, V>>
+class BoundedCache
+{
+public:
+	using Entry = CacheEntry<K, V>;
+
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+
+		double hitRatio() const
+		{
+			return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+		}
+	};
+
+public:
+	BoundedCache(const size_t maxEntries, const size_t maxBytes = std::numeric_limits<size_t>::max())
+		:
+		maxEntries(maxEntries),
+		maxBytes(maxBytes),
+		bytes(0)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	BoundedCache(const BoundedCache&) = delete;
+	BoundedCache(BoundedCache&&) = delete;
+
+	~BoundedCache()
+	{
+		clear();
+	}
+
+	/*
+	*	Returns the cached value or nullptr, and counts the hit or miss.
+	*/
+	V* get(const K& key)
+	{
+		Entry** entry = entries.find(key);
+		if (entry == nullptr)
+		{
+			++stats.misses;
+			return nullptr;
+		}
+
+		++stats.hits;
+		policy.onHit(**entry);
+		return &(*entry)->value;
+	}
+
+	// Lookup that neither counts nor changes the eviction order
+	bool contains(const K& key) const
+	{
+		return entries.contains(key);
+	}
+
+	/*
+	*	Inserts or overwrites the value of key and evicts other entries until both bounds hold
+	*	again, key itself is never the victim of its own put.
+	*	Returns false if the entry alone is larger than the byte bound; it is not cached then
+	*	(and an old value of the key is dropped).
+	*/
+	bool put(const K& key, const V& value)
+	{
+		const size_t entryBytes = Sizer{}(key, value);
+		Entry** existing = entries.find(key);
+		if (existing != nullptr)
+		{
+			Entry* entry = *existing;
+			if (entryBytes > maxBytes)
+			{
+				removeEntry(entry);
+				return false;
+			}
+
+			entry->value = value;
+			bytes = bytes - entry->bytes + entryBytes;
+			entry->bytes = entryBytes;
+			if (bytes > maxBytes)
+			{
+				// a larger value needs room: take the entry out of the eviction order meanwhile,
+				// so (like a new entry) it can't be its own victim
+				policy.onErase(*entry);
+				evictUntil(maxEntries, maxBytes);
+				policy.onInsert(*entry);
+			}
+			policy.onHit(*entry);
+			return true;
+		}
+
+		if (entryBytes > maxBytes || maxEntries == 0)
+		{
+			return false;
+		}
+
+		// make room first, so the new entry can't be its own victim
+		evictUntil(maxEntries - 1, maxBytes - entryBytes);
+
+		Entry* entry = new Entry(key, value, Hash{}(key), entryBytes);
+		entries.insert(key, entry);
+		bytes += entryBytes;
+		policy.onInsert(*entry);
+		return true;
+	}
+
+	bool erase(const K& key)
+	{
+		Entry** entry = entries.find(key);
+		if (entry == nullptr)
+		{
+			return false;
+		}
+
+		removeEntry(*entry);
+		return true;
+	}
+
+	void clear()
+	{
+		entries.forEach([this](const K&, Entry* entry)
+			{
+				policy.onErase(*entry);
+				delete entry;
+			});
+		entries.clear();
+		bytes = 0;
+	}
+
+	size_t size() const
+	{
+		return entries.size();
+	}
+
+	size_t getBytes() const
+	{
+		return bytes;
+	}
+
+	size_t getMaxEntries() const
+	{
+		return maxEntries;
+	}
+
+	size_t getMaxBytes() const
+	{
+		return maxBytes;
+	}
+
+	const Stats& getStats() const
+	{
+		return stats;
+	}
+
+	void resetStats()
+	{
+		stats = Stats();
+	}
+
+	void printStats() const
+	{
+		std::cout << "Entries: " << size() << "/" << maxEntries << "\t" << "Bytes: " << bytes << "\n";
+		std::cout << "Hits: " << stats.hits << "\t" << "Misses: " << stats.misses << "\t" << "Evictions: " << stats.evictions << "\t"
+			<< "Hit ratio: " << stats.hitRatio() * 100.0 << "%" << std::endl;
+	}
+
+private:
+	void evictUntil(const size_t entryLimit, const size_t byteLimit)
+	{
+		while (entries.size() > entryLimit || bytes > byteLimit)
+		{
+			removeEntry(policy.victim());
+			++stats.evictions;
+		}
+	}
+
+	void removeEntry(Entry* entry)
+	{
+		policy.onErase(*entry);
+		entries.erase(entry->key);
+		bytes -= entry->bytes;
+		delete entry;
+	}
+
+private:
+	FlatHashTable<K, Entry*, Hash> entries;
+	Policy<Entry> policy;
+	size_t maxEntries;
+	size_t maxBytes;
+	size_t bytes;
+	Stats stats;
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include "../LinkedList/Node.h"
+#include "HashPolicies.h"
+
+/*
+*	Thread-safe chaining hash table with lock striping.
+*	The buckets are split over a fixed number of stripes, each guarded by its own reader/writer
+*	lock, so get calls on any stripe and put calls on different stripes run in parallel instead
+*	of queueing behind one table wide mutex.
+*
+*	Bucket i always belongs to stripe (i % STRIPE_COUNT): the bucket count is a power of two and
+*	a multiple of STRIPE_COUNT, so a key keeps its stripe when the table grows. Growing takes
+*	every stripe lock (in order, so two growing threads can't deadlock) and relinks the existing
+*	nodes into the new bucket array without allocating.
+*
+*	Keys are hashed with Hash like HashTable::hashFunc does, masked instead of reduced. The mask
+*	keeps the low bits, so a custom Hash needs well mixed low bits (FastHash has).
+*
+*	Keys are compared with KeyEqual. When Hash and KeyEqual are both transparent (the defaults
+*	for std::string keys) get/contains/deleteKey take any key comparable to K, e.g. a
+*	std::string_view, without building a temporary K.
+*/
+template<typename K, typename V, typename Hash = FastHash<K>, typename KeyEqual = std::equal_to<>>
+class ConcurrentHashTable
+{
+public:
+	using Entry = std::pair<K, V>;
+
+private:
+	// K itself, or any key type if the lookup is transparent
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, K>::value || IsTransparentLookup<Hash, KeyEqual>::value>::type;
+
+public:
+	ConcurrentHashTable(const size_t capacity = STRIPE_COUNT)
+		:
+		bucketCount(roundUpToPowerOfTwo(capacity)),
+		buckets(new Node<Entry>*[bucketCount.load()]()),
+		count(0)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+	ConcurrentHashTable(ConcurrentHashTable&&) = delete;
+
+	~ConcurrentHashTable()
+	{
+		const size_t bucketTotal = bucketCount.load();
+		for (size_t i = 0; i < bucketTotal; ++i)
+		{
+			Node<Entry>* currNode = buckets[i];
+			while (currNode != nullptr)
+			{
+				auto nextNode = currNode->next;
+				delete currNode;
+				currNode = nextNode;
+			}
+		}
+		delete[] buckets;
+	}
+
+	/*
+	*	Inserts the pair or overwrites the value of an existing key.
+	*	Returns true if a new key was inserted.
+	*/
+	bool put(const K& key, const V& value)
+	{
+		const size_t hash = hashFunc(key);
+		{
+			std::unique_lock<std::shared_mutex> lock(stripeOf(hash).mutex);
+			Node<Entry>*& head = buckets[hash & (bucketCount.load(std::memory_order_relaxed) - 1)];
+
+			for (Node<Entry>* currNode = head; currNode != nullptr; currNode = currNode->next)
+			{
+				if (KeyEqual{}(currNode->data.first, key))
+				{
+					currNode->data.second = value;
+					return false;
+				}
+			}
+
+			head = new Node<Entry>(Entry(key, value), head);
+		}
+
+		const size_t newCount = count.fetch_add(1, std::memory_order_relaxed) + 1;
+		if (newCount > bucketCount.load(std::memory_order_relaxed) * MAX_LOAD_FACTOR)
+		{
+			grow(newCount);
+		}
+		return true;
+	}
+
+	std::optional<V> get(const K& key) const
+	{
+		return get<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	std::optional<V> get(const Key& key) const
+	{
+		const size_t hash = hashFunc(key);
+		std::shared_lock<std::shared_mutex> lock(stripeOf(hash).mutex);
+
+		for (Node<Entry>* currNode = buckets[hash & (bucketCount.load(std::memory_order_relaxed) - 1)];
+			 currNode != nullptr;
+			 currNode = currNode->next)
+		{
+			if (KeyEqual{}(currNode->data.first, key))
+			{
+				return currNode->data.second;
+			}
+		}
+		return std::nullopt;
+	}
+
+	bool contains(const K& key) const
+	{
+		return get<K>(key).has_value();
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool contains(const Key& key) const
+	{
+		return get<Key>(key).has_value();
+	}
+
+	bool deleteKey(const K& key)
+	{
+		return deleteKey<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool deleteKey(const Key& key)
+	{
+		const size_t hash = hashFunc(key);
+		std::unique_lock<std::shared_mutex> lock(stripeOf(hash).mutex);
+		Node<Entry>** link = &buckets[hash & (bucketCount.load(std::memory_order_relaxed) - 1)];
+
+		while (*link != nullptr)
+		{
+			if (KeyEqual{}((*link)->data.first, key))
+			{
+				Node<Entry>* toDelete = *link;
+				*link = toDelete->next;
+				delete toDelete;
+				count.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+			link = &(*link)->next;
+		}
+		return false;
+	}
+
+	/*
+	*	Removes every entry for which pred(key, value) returns true and returns how many were
+	*	removed. The sweep locks one stripe at a time, so gets and puts on the other stripes keep
+	*	running while expired entries are dropped.
+	*/
+	template<typename Pred>
+	size_t erase_if(Pred pred)
+	{
+		size_t removed = 0;
+		for (size_t stripe = 0; stripe < STRIPE_COUNT; ++stripe)
+		{
+			size_t stripeRemoved = 0;
+			std::unique_lock<std::shared_mutex> lock(stripes[stripe].mutex);
+			// growing needs every stripe lock, so the bucket array is stable while we hold one
+			const size_t bucketTotal = bucketCount.load(std::memory_order_relaxed);
+			for (size_t bucket = stripe; bucket < bucketTotal; bucket += STRIPE_COUNT)
+			{
+				Node<Entry>** link = &buckets[bucket];
+				while (*link != nullptr)
+				{
+					if (pred((*link)->data.first, (*link)->data.second))
+					{
+						Node<Entry>* toDelete = *link;
+						*link = toDelete->next;
+						delete toDelete;
+						++stripeRemoved;
+					}
+					else
+					{
+						link = &(*link)->next;
+					}
+				}
+			}
+			count.fetch_sub(stripeRemoved, std::memory_order_relaxed);
+			removed += stripeRemoved;
+		}
+		return removed;
+	}
+
+	size_t size() const
+	{
+		return count.load(std::memory_order_relaxed);
+	}
+
+	size_t getCapacity() const
+	{
+		return bucketCount.load(std::memory_order_relaxed);
+	}
+
+	static size_t hashFunc(const K& key)
+	{
+		return Hash{}(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	static size_t hashFunc(const Key& key)
+	{
+		return Hash{}(key);
+	}
+
+private:
+	static constexpr size_t STRIPE_COUNT = 64;
+	static constexpr size_t MAX_LOAD_FACTOR = 1;
+
+	// One stripe per cache line so threads locking neighbouring stripes don't share a line
+	struct alignas(64) Stripe
+	{
+		mutable std::shared_mutex mutex;
+	};
+
+	static size_t roundUpToPowerOfTwo(size_t value)
+	{
+		size_t result = STRIPE_COUNT;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	Stripe& stripeOf(const size_t hash) const
+	{
+		return stripes[hash & (STRIPE_COUNT - 1)];
+	}
+
+	void grow(const size_t seenCount)
+	{
+		// lock all stripes in ascending order; whoever gets here second re-checks and backs off
+		std::unique_lock<std::shared_mutex> locks[STRIPE_COUNT];
+		for (size_t i = 0; i < STRIPE_COUNT; ++i)
+		{
+			locks[i] = std::unique_lock<std::shared_mutex>(stripes[i].mutex);
+		}
+
+		const size_t oldBucketCount = bucketCount.load(std::memory_order_relaxed);
+		if (seenCount <= oldBucketCount * MAX_LOAD_FACTOR)
+		{
+			return;
+		}
+
+		const size_t newBucketCount = oldBucketCount * 2;
+		Node<Entry>** newBuckets = new Node<Entry>*[newBucketCount]();
+		for (size_t i = 0; i < oldBucketCount; ++i)
+		{
+			Node<Entry>* currNode = buckets[i];
+			while (currNode != nullptr)
+			{
+				Node<Entry>* nextNode = currNode->next;
+				Node<Entry>*& head = newBuckets[hashFunc(currNode->data.first) & (newBucketCount - 1)];
+				currNode->next = head;
+				head = currNode;
+				currNode = nextNode;
+			}
+		}
+
+		delete[] buckets;
+		buckets = newBuckets;
+		bucketCount.store(newBucketCount, std::memory_order_relaxed);
+	}
+
+private:
+	mutable Stripe stripes[STRIPE_COUNT];
+	std::atomic<size_t> bucketCount;
+	Node<Entry>** buckets;
+	std::atomic<size_t> count;
+};
@@ -0,0 +1 @@
+#include <FlatHashTable.h>
\ No newline at end of file
@@ -0,0 +1,827 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "HashPolicies.h"
+#include "HashTableSnapshot.h"
+
+/*
+*	Open-addressing hash table using Robin Hood linear probing.
+*	Keys and values are stored in place in one contiguous slot array, so a lookup usually
+*	touches a single cache line instead of chasing bucket -> list -> node pointers like the
+*	legacy chaining HashTable does.
+*
+*	Every slot keeps its distance to the home bucket (dist - 1, 0 = empty). Robin Hood
+*	insertion keeps those distances low and lets a failed lookup stop early, and erase
+*	shifts the following cluster back one slot so no tombstones are ever needed.
+*
+*	The capacity is always a power of two and doubles when the load factor would exceed
+*	max_load_factor(). With set_incremental_rehash(true) a growth step only allocates the new
+*	slot array; the old one is drained a bounded number of slots per insert/erase, so a single
+*	insert never has to move the whole table.
+*
+*	Keys are compared with KeyEqual. When Hash and KeyEqual are both transparent (the defaults
+*	for std::string keys) find/contains/erase take any key comparable to K, e.g. a
+*	std::string_view or const char*, without building a temporary K.
+*/
+template<typename K, typename V, typename Hash = FastHash<K>, typename KeyEqual = std::equal_to<>>
+class FlatHashTable
+{
+public:
+	using Entry = std::pair<K, V>;
+
+private:
+	// K itself, or any key type if the lookup is transparent
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, K>::value || IsTransparentLookup<Hash, KeyEqual>::value>::type;
+
+public:
+	FlatHashTable(const size_t capacity = MIN_CAPACITY)
+		:
+		table(roundUpToPowerOfTwo(capacity)),
+		oldTable(),
+		migrateCursor(0),
+		maxLoadFactor(DEFAULT_MAX_LOAD_FACTOR),
+		incrementalRehash(false)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	FlatHashTable(const FlatHashTable&) = delete;
+	FlatHashTable(FlatHashTable&&) = delete;
+
+	~FlatHashTable()
+	{
+		table.release();
+		oldTable.release();
+	}
+
+	V* find(const K& key)
+	{
+		return find<K>(key);
+	}
+
+	const V* find(const K& key) const
+	{
+		return find<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	V* find(const Key& key)
+	{
+		Slot* slot = findSlot(key);
+		return slot == nullptr ? nullptr : &slot->entry().second;
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	const V* find(const Key& key) const
+	{
+		const Slot* slot = const_cast<FlatHashTable*>(this)->findSlot(key);
+		return slot == nullptr ? nullptr : &slot->entry().second;
+	}
+
+	bool contains(const K& key) const
+	{
+		return find<K>(key) != nullptr;
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool contains(const Key& key) const
+	{
+		return find<Key>(key) != nullptr;
+	}
+
+	/*
+	*	Looks up keyCount keys at once. results[i] points to the value of keys[i] or is nullptr if
+	*	the key is absent. Returns the number of keys found.
+	*
+	*	The keys are handled in chunks: first every key of a chunk is hashed and the cache line of
+	*	its home slot is prefetched, only then are the keys resolved. The memory latency of the
+	*	whole chunk overlaps instead of stalling once per key as a loop over find would.
+	*/
+	size_t get_batch(const K* keys, const size_t keyCount, V** results)
+	{
+		size_t hits = 0;
+		size_t hashes[BATCH_CHUNK];
+
+		for (size_t base = 0; base < keyCount; base += BATCH_CHUNK)
+		{
+			const size_t chunk = keyCount - base < BATCH_CHUNK ? keyCount - base : BATCH_CHUNK;
+			prefetchChunk(keys + base, chunk, hashes);
+
+			for (size_t i = 0; i < chunk; ++i)
+			{
+				Slot* slot = findSlot(keys[base + i], hashes[i]);
+				results[base + i] = slot == nullptr ? nullptr : &slot->entry().second;
+				hits += slot == nullptr ? 0 : 1;
+			}
+		}
+
+		return hits;
+	}
+
+	/*
+	*	insert_or_assign for keyCount pairs at once, prefetching like get_batch does. The table is
+	*	grown up front for the whole batch so the prefetched slots stay valid.
+	*	Returns the number of newly inserted keys.
+	*/
+	size_t put_batch(const K* keys, const V* values, const size_t keyCount)
+	{
+		if (static_cast<float>(size() + keyCount) > static_cast<float>(table.capacity) * maxLoadFactor)
+		{
+			reserve(size() + keyCount);
+		}
+
+		size_t inserted = 0;
+		size_t hashes[BATCH_CHUNK];
+
+		for (size_t base = 0; base < keyCount; base += BATCH_CHUNK)
+		{
+			const size_t chunk = keyCount - base < BATCH_CHUNK ? keyCount - base : BATCH_CHUNK;
+			prefetchChunk(keys + base, chunk, hashes);
+
+			for (size_t i = 0; i < chunk; ++i)
+			{
+				Slot* slot = findSlot(keys[base + i], hashes[i]);
+				if (slot != nullptr)
+				{
+					slot->entry().second = values[base + i];
+				}
+				else
+				{
+					insertUnique(table, Entry(keys[base + i], values[base + i]));
+					++inserted;
+				}
+			}
+		}
+
+		return inserted;
+	}
+
+	/*
+	*	Inserts the pair if the key is not present yet. Returns false (and leaves the stored
+	*	value untouched) when the key already exists.
+	*/
+	bool insert(const K& key, const V& value)
+	{
+		migrateStep();
+		if (findSlot(key) != nullptr)
+		{
+			return false;
+		}
+
+		growIfNeeded();
+		insertUnique(table, Entry(key, value));
+		return true;
+	}
+
+	/*
+	*	Inserts the pair or overwrites the value of an existing key.
+	*	Returns true if a new key was inserted, false if an existing value was assigned.
+	*/
+	bool insert_or_assign(const K& key, const V& value)
+	{
+		migrateStep();
+		Slot* slot = findSlot(key);
+		if (slot != nullptr)
+		{
+			slot->entry().second = value;
+			return false;
+		}
+
+		growIfNeeded();
+		insertUnique(table, Entry(key, value));
+		return true;
+	}
+
+	/*
+	*	Removes only the given key. The entries behind it in the same cluster are shifted
+	*	back one slot (backward-shift deletion) so the table never contains tombstones.
+	*/
+	bool erase(const K& key)
+	{
+		return erase<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool erase(const Key& key)
+	{
+		migrateStep();
+		const auto idx = findIndex(table, key);
+		if (idx != NOT_FOUND)
+		{
+			eraseAt(idx);
+			return true;
+		}
+
+		if (isMigrating())
+		{
+			// The draining table is never probed for inserts, so it can simply mark the slot
+			// as vacated instead of shifting entries back over the migration cursor.
+			const auto oldIdx = findIndex(oldTable, key);
+			if (oldIdx != NOT_FOUND)
+			{
+				vacate(oldTable.slots[oldIdx]);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/*
+	*	Removes every entry for which pred(key, value) returns true and returns how many were
+	*	removed. Instead of one backward shift per erased entry, the survivors of each cluster
+	*	are moved back during the same sweep, so a bulk expiry is one linear pass over the slots
+	*	no matter how many entries go.
+	*/
+	template<typename Pred>
+	size_t erase_if(Pred pred)
+	{
+		size_t removed = 0;
+		if (isMigrating())
+		{
+			// like erase, the draining table only marks slots as vacated
+			for (size_t i = migrateCursor; i < oldTable.capacity; ++i)
+			{
+				Slot& slot = oldTable.slots[i];
+				if (slot.dist != EMPTY && (slot.dist & VACATED) == 0 && pred(slot.entry().first, slot.entry().second))
+				{
+					vacate(slot);
+					++removed;
+				}
+			}
+		}
+		return removed + compactIf(pred);
+	}
+
+	/*
+	*	Keeps only the entries for which pred(key, value) returns true, in the same single sweep
+	*	as erase_if. pred may update the values it keeps. Returns the number of removed entries.
+	*/
+	template<typename Pred>
+	size_t retain(Pred pred)
+	{
+		return erase_if([&pred](const K& key, V& value)
+			{
+				return !pred(key, value);
+			});
+	}
+
+	void clear()
+	{
+		oldTable.release();
+		migrateCursor = 0;
+		table.destroyEntries();
+	}
+
+	size_t size() const
+	{
+		return table.count + oldTable.count;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return table.capacity;
+	}
+
+	float load_factor() const
+	{
+		return static_cast<float>(size()) / static_cast<float>(table.capacity);
+	}
+
+	float max_load_factor() const
+	{
+		return maxLoadFactor;
+	}
+
+	/*
+	*	Sets the load factor at which the table doubles. Robin Hood probing degrades quickly
+	*	close to a full table, so the value is clamped to [MIN_MAX_LOAD_FACTOR, MAX_MAX_LOAD_FACTOR].
+	*/
+	void max_load_factor(const float newMaxLoadFactor)
+	{
+		maxLoadFactor = newMaxLoadFactor < MIN_MAX_LOAD_FACTOR ? MIN_MAX_LOAD_FACTOR
+			: newMaxLoadFactor > MAX_MAX_LOAD_FACTOR ? MAX_MAX_LOAD_FACTOR
+			: newMaxLoadFactor;
+		growIfNeeded(0);
+	}
+
+	/*
+	*	Makes room for at least entryCount entries without growing again.
+	*/
+	void reserve(const size_t entryCount)
+	{
+		rehash(static_cast<size_t>(static_cast<float>(entryCount) / maxLoadFactor) + 1);
+	}
+
+	/*
+	*	Rebuilds the table with at least slotCount slots (rounded up to a power of two and never
+	*	below what the current entries need). Always done in one go, also in incremental mode.
+	*/
+	void rehash(const size_t slotCount)
+	{
+		finishMigration();
+		const size_t needed = static_cast<size_t>(static_cast<float>(size()) / maxLoadFactor) + 1;
+		const size_t newCapacity = roundUpToPowerOfTwo(slotCount > needed ? slotCount : needed);
+		if (newCapacity != table.capacity)
+		{
+			startRehash(newCapacity);
+			finishMigration();
+		}
+	}
+
+	/*
+	*	Incremental mode spreads the cost of a growth step over the following inserts and erases.
+	*/
+	void set_incremental_rehash(const bool enabled)
+	{
+		incrementalRehash = enabled;
+		if (!enabled)
+		{
+			finishMigration();
+		}
+	}
+
+	bool isMigrating() const
+	{
+		return oldTable.slots != nullptr;
+	}
+
+	/*
+	*	Calls func(key, value) for every stored entry in slot order.
+	*/
+	template<typename Func>
+	void forEach(Func func) const
+	{
+		table.forEach(func);
+		oldTable.forEach(func);
+	}
+
+	/*
+	*	Writes the entries as a snapshot file that MappedHashTable<K, V> can map and query without
+	*	loading it. K has to be trivially copyable without padding, V trivially copyable.
+	*	Throws std::runtime_error if the file can't be written.
+	*/
+	void save(const std::string& path) const
+	{
+		HashTableSnapshot<K, V> snapshot(size());
+		forEach([&snapshot](const K& key, const V& value)
+			{
+				snapshot.add(key, value);
+			});
+		snapshot.save(path);
+	}
+
+	void printBinsInfo() const
+	{
+		for (size_t i = 0; i < table.capacity; ++i)
+		{
+			if (table.slots[i].dist != EMPTY)
+			{
+				std::cout << "Slot: " << i << "\t" << "Probe distance: " << table.slots[i].dist - 1 << std::endl;
+			}
+			else
+			{
+				std::cout << "[UNUSED] Slot: " << i << std::endl;
+			}
+		}
+		getDistributionStats().print("probe length");
+	}
+
+	/*
+	*	Probe length (distance from the home slot) statistics over all entries. Entries still
+	*	waiting in the old array of a running incremental rehash are not counted.
+	*/
+	HashDistributionStats getDistributionStats() const
+	{
+		HashDistributionStats stats;
+		stats.buckets = table.capacity;
+		stats.entries = table.count;
+		stats.emptyBuckets = table.capacity - table.count;
+		if (table.count == 0)
+		{
+			return stats;
+		}
+
+		double sum = 0;
+		double sumOfSquares = 0;
+		for (size_t i = 0; i < table.capacity; ++i)
+		{
+			if (table.slots[i].dist != EMPTY)
+			{
+				const size_t probeLength = table.slots[i].dist - 1;
+				stats.maxLength = probeLength > stats.maxLength ? probeLength : stats.maxLength;
+				sum += static_cast<double>(probeLength);
+				sumOfSquares += static_cast<double>(probeLength) * static_cast<double>(probeLength);
+			}
+		}
+		stats.meanLength = sum / static_cast<double>(table.count);
+		stats.variance = sumOfSquares / static_cast<double>(table.count) - stats.meanLength * stats.meanLength;
+		return stats;
+	}
+
+private:
+	struct Slot
+	{
+		uint32_t dist; // probe distance + 1, EMPTY (0) if the slot holds no entry
+		typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage;
+
+		Entry& entry()
+		{
+			return *std::launder(reinterpret_cast<Entry*>(&storage));
+		}
+
+		const Entry& entry() const
+		{
+			return *std::launder(reinterpret_cast<const Entry*>(&storage));
+		}
+	};
+
+	/*
+	*	One power of two sized slot array. The table owns one of these and, while an
+	*	incremental rehash is running, a second one that is being drained.
+	*/
+	struct SlotArray
+	{
+		SlotArray()
+			:
+			capacity(0),
+			shift(0),
+			count(0),
+			slots(nullptr)
+		{
+		}
+
+		explicit SlotArray(const size_t capacity)
+			:
+			capacity(capacity),
+			shift(FibonacciReducer::shiftFor(capacity)),
+			count(0),
+			slots(static_cast<Slot*>(std::calloc(capacity, sizeof(Slot))))
+		{
+			// calloc instead of new Slot[]() so that a huge table gets lazily zeroed pages from the OS
+			// and growing does not first have to touch every new slot
+			if (slots == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+		}
+
+		void destroyEntries()
+		{
+			for (size_t i = 0; i < capacity; ++i)
+			{
+				if (slots[i].dist != EMPTY && (slots[i].dist & VACATED) == 0)
+				{
+					slots[i].entry().~Entry();
+				}
+				slots[i].dist = EMPTY;
+			}
+			count = 0;
+		}
+
+		void release()
+		{
+			if (slots != nullptr)
+			{
+				// a fully drained table has nothing left to destroy, skip the scan
+				if (count != 0)
+				{
+					destroyEntries();
+				}
+				std::free(slots);
+			}
+			*this = SlotArray();
+		}
+
+		template<typename Func>
+		void forEach(Func& func) const
+		{
+			for (size_t i = 0; i < capacity; ++i)
+			{
+				if (slots[i].dist != EMPTY && (slots[i].dist & VACATED) == 0)
+				{
+					func(slots[i].entry().first, slots[i].entry().second);
+				}
+			}
+		}
+
+		size_t capacity;
+		unsigned shift;
+		size_t count;
+		Slot* slots;
+	};
+
+	static_assert(alignof(Slot) <= alignof(std::max_align_t), "over-aligned keys/values are not supported");
+
+	static constexpr size_t MIN_CAPACITY = 16;
+	static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+	static constexpr uint32_t EMPTY = 0;
+	// set on slots of a draining table whose entry was migrated or erased, the distance is
+	// kept so probes for the rest of the cluster still work
+	static constexpr uint32_t VACATED = 0x80000000u;
+	static constexpr uint32_t DIST_MASK = ~VACATED;
+	// keys hashed and prefetched together by get_batch/put_batch, enough to cover DRAM latency
+	static constexpr size_t BATCH_CHUNK = 16;
+	// old slots moved per insert/erase while an incremental rehash is running
+	static constexpr size_t MIGRATE_STEP = 64;
+	// Robin Hood probing stays short up to high load factors
+	static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.875f;
+	static constexpr float MIN_MAX_LOAD_FACTOR = 0.25f;
+	static constexpr float MAX_MAX_LOAD_FACTOR = 0.95f;
+
+	static size_t roundUpToPowerOfTwo(size_t value)
+	{
+		size_t result = MIN_CAPACITY;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	template<typename Key>
+	static size_t hashOf(const Key& key)
+	{
+		return Hash{}(key);
+	}
+
+	// Fibonacci hashing keeps the top bits, so a custom Hash that is weak in the low bits (like
+	// std::hash for integers) still spreads over the whole table.
+	static size_t homeIndex(const SlotArray& arr, const size_t hash)
+	{
+		return FibonacciReducer::reduce(hash, arr.shift);
+	}
+
+	template<typename Key>
+	static size_t findIndex(const SlotArray& arr, const Key& key)
+	{
+		return findIndex(arr, key, hashOf(key));
+	}
+
+	template<typename Key>
+	static size_t findIndex(const SlotArray& arr, const Key& key, const size_t hash)
+	{
+		const size_t mask = arr.capacity - 1;
+		size_t idx = homeIndex(arr, hash);
+		uint32_t dist = 1;
+
+		// Robin Hood invariant: once we meet an entry closer to its home than we are to ours,
+		// the key cannot be further down the cluster.
+		while ((arr.slots[idx].dist & DIST_MASK) >= dist)
+		{
+			if (arr.slots[idx].dist == dist && KeyEqual{}(arr.slots[idx].entry().first, key))
+			{
+				return idx;
+			}
+			idx = (idx + 1) & mask;
+			++dist;
+		}
+
+		return NOT_FOUND;
+	}
+
+	template<typename Key>
+	Slot* findSlot(const Key& key)
+	{
+		return findSlot(key, hashOf(key));
+	}
+
+	template<typename Key>
+	Slot* findSlot(const Key& key, const size_t hash)
+	{
+		auto idx = findIndex(table, key, hash);
+		if (idx != NOT_FOUND)
+		{
+			return &table.slots[idx];
+		}
+
+		if (isMigrating())
+		{
+			idx = findIndex(oldTable, key, hash);
+			if (idx != NOT_FOUND)
+			{
+				return &oldTable.slots[idx];
+			}
+		}
+
+		return nullptr;
+	}
+
+	void prefetchChunk(const K* keys, const size_t chunk, size_t* hashes) const
+	{
+		for (size_t i = 0; i < chunk; ++i)
+		{
+			hashes[i] = hashOf(keys[i]);
+			prefetch(&table.slots[homeIndex(table, hashes[i])]);
+		}
+	}
+
+	static void prefetch(const void* address)
+	{
+#if defined(_MSC_VER)
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+		__builtin_prefetch(address);
+#endif
+	}
+
+	// Caller guarantees the key is not present and there is room for one more entry.
+	static void insertUnique(SlotArray& arr, Entry&& entry)
+	{
+		const size_t mask = arr.capacity - 1;
+		size_t idx = homeIndex(arr, hashOf(entry.first));
+		uint32_t dist = 1;
+
+		while (true)
+		{
+			Slot& slot = arr.slots[idx];
+			if (slot.dist == EMPTY)
+			{
+				new (&slot.storage) Entry(std::move(entry));
+				slot.dist = dist;
+				++arr.count;
+				return;
+			}
+
+			// steal the slot from a richer entry and carry that one further down the cluster
+			if (slot.dist < dist)
+			{
+				std::swap(slot.entry(), entry);
+				std::swap(slot.dist, dist);
+			}
+
+			idx = (idx + 1) & mask;
+			++dist;
+		}
+	}
+
+	void eraseAt(size_t idx)
+	{
+		const size_t mask = table.capacity - 1;
+		Slot* slots = table.slots;
+		slots[idx].entry().~Entry();
+		slots[idx].dist = EMPTY;
+		--table.count;
+
+		size_t next = (idx + 1) & mask;
+		while (slots[next].dist > 1)
+		{
+			new (&slots[idx].storage) Entry(std::move(slots[next].entry()));
+			slots[idx].dist = slots[next].dist - 1;
+			slots[next].entry().~Entry();
+			slots[next].dist = EMPTY;
+
+			idx = next;
+			next = (next + 1) & mask;
+		}
+	}
+
+	/*
+	*	Sweep behind erase_if over the live table. The entries of a cluster are ordered by home
+	*	slot, so moving every survivor to the first free slot at or after its home gives the same
+	*	layout as erasing the removed entries one by one with backward shifts.
+	*	Positions are counted from a slot that is empty before the sweep (the load factor leaves at
+	*	least one), so no cluster wraps around the start and positions can be compared directly.
+	*/
+	template<typename Pred>
+	size_t compactIf(Pred& pred)
+	{
+		const size_t mask = table.capacity - 1;
+		Slot* slots = table.slots;
+
+		size_t start = 0;
+		while (slots[start].dist != EMPTY)
+		{
+			++start;
+		}
+
+		size_t removed = 0;
+		size_t firstFree = start + 1; // where the next survivor of the current cluster may go
+		for (size_t pos = start + 1; pos <= start + table.capacity; ++pos)
+		{
+			Slot& slot = slots[pos & mask];
+			if (slot.dist == EMPTY)
+			{
+				firstFree = pos + 1;
+				continue;
+			}
+
+			if (pred(slot.entry().first, slot.entry().second))
+			{
+				slot.entry().~Entry();
+				slot.dist = EMPTY;
+				++removed;
+				continue;
+			}
+
+			const size_t home = pos - (slot.dist - 1);
+			const size_t target = firstFree > home ? firstFree : home;
+			if (target != pos)
+			{
+				Slot& destination = slots[target & mask];
+				new (&destination.storage) Entry(std::move(slot.entry()));
+				destination.dist = static_cast<uint32_t>(target - home + 1);
+				slot.entry().~Entry();
+				slot.dist = EMPTY;
+			}
+			firstFree = target + 1;
+		}
+
+		table.count -= removed;
+		return removed;
+	}
+
+	void vacate(Slot& slot)
+	{
+		slot.entry().~Entry();
+		slot.dist |= VACATED;
+		--oldTable.count;
+	}
+
+	void growIfNeeded(const size_t extraEntries = 1)
+	{
+		if (static_cast<float>(size() + extraEntries) > static_cast<float>(table.capacity) * maxLoadFactor)
+		{
+			// a migration that is still running has to finish before the next one can start
+			finishMigration();
+			startRehash(table.capacity * 2);
+			if (!incrementalRehash)
+			{
+				finishMigration();
+			}
+		}
+	}
+
+	void startRehash(const size_t newCapacity)
+	{
+		// allocate first: if that throws, table and oldTable must not share their slots
+		const SlotArray grown(newCapacity);
+		oldTable = table;
+		table = grown;
+		migrateCursor = 0;
+	}
+
+	/*
+	*	Moves up to maxSlots slots of the draining table into the live one and frees the draining
+	*	table once the cursor has passed all of its slots.
+	*/
+	void migrate(const size_t maxSlots)
+	{
+		if (!isMigrating())
+		{
+			return;
+		}
+
+		const size_t end = migrateCursor + maxSlots < oldTable.capacity ? migrateCursor + maxSlots : oldTable.capacity;
+		for (; migrateCursor < end; ++migrateCursor)
+		{
+			Slot& slot = oldTable.slots[migrateCursor];
+			if (slot.dist != EMPTY && (slot.dist & VACATED) == 0)
+			{
+				insertUnique(table, std::move(slot.entry()));
+				vacate(slot);
+			}
+		}
+
+		if (migrateCursor == oldTable.capacity)
+		{
+			oldTable.release();
+			migrateCursor = 0;
+		}
+	}
+
+	void migrateStep()
+	{
+		migrate(MIGRATE_STEP);
+	}
+
+	void finishMigration()
+	{
+		migrate(oldTable.capacity);
+	}
+
+private:
+	SlotArray table;
+	SlotArray oldTable;
+	size_t migrateCursor;
+	float maxLoadFactor;
+	bool incrementalRehash;
+};
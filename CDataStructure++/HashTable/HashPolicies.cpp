@@ -0,0 +1 @@
+#include <HashPolicies.h>
\ No newline at end of file
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+*	Hash and bucket reduction policies shared by the hash tables.
+*
+*	FastHash<K> is the default Hash of every table. With libstdc++ std::hash maps integers to
+*	themselves, so strided keys (multiples of 64, pointers, ...) pile up in a few buckets.
+*	FastHash runs integers through a 64x64->128 bit multiply-xor mix and hashes strings with a
+*	wyhash style loop over 8/16 byte words. Any other type falls back to mixing its std::hash.
+*
+*	Reducers turn a hash into a bucket index without an integer division:
+*		FibonacciReducer - power of two bucket counts, keeps the top bits of hash * 2^64/phi
+*		RangeReducer	 - any bucket count, (scrambled hash * buckets) >> 64
+*/
+
+inline uint64_t mulHigh64(const uint64_t a, const uint64_t b, uint64_t& low)
+{
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	low = static_cast<uint64_t>(product);
+	return static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high;
+	low = _umul128(a, b, &high);
+	return high;
+#else
+	const uint64_t aLow = a & 0xFFFFFFFFull, aHigh = a >> 32;
+	const uint64_t bLow = b & 0xFFFFFFFFull, bHigh = b >> 32;
+	const uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+	const uint64_t cross = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFull) + highLow;
+	low = (cross << 32) | (lowLow & 0xFFFFFFFFull);
+	return highHigh + (lowHigh >> 32) + (cross >> 32);
+#endif
+}
+
+// 128 bit product folded back to 64 bits: every input bit influences every output bit
+inline uint64_t hashMix(const uint64_t a, const uint64_t b)
+{
+	uint64_t low;
+	const uint64_t high = mulHigh64(a, b, low);
+	return low ^ high;
+}
+
+namespace hash_detail
+{
+	constexpr uint64_t SECRET0 = 0xa0761d6478bd642full;
+	constexpr uint64_t SECRET1 = 0xe7037ed1a0b428dbull;
+	constexpr uint64_t SECRET2 = 0x8ebc6af09c88c6e3ull;
+	constexpr uint64_t SECRET3 = 0x589965cc75374cc3ull;
+
+	inline uint64_t read64(const uint8_t* p)
+	{
+		uint64_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	inline uint64_t read32(const uint8_t* p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	// 1 to 3 bytes: first, middle and last byte
+	inline uint64_t read1To3(const uint8_t* p, const size_t len)
+	{
+		return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+	}
+}
+
+/*
+*	wyhash style byte hash: 16 bytes per multiply, three independent lanes for inputs over 48 bytes.
+*/
+inline uint64_t hashBytes(const void* data, const size_t len, uint64_t seed = 0)
+{
+	using namespace hash_detail;
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	seed ^= hashMix(seed ^ SECRET0, SECRET1);
+
+	uint64_t a;
+	uint64_t b;
+	if (len <= 16)
+	{
+		if (len >= 4)
+		{
+			const size_t offset = (len >> 3) << 2;
+			a = (read32(p) << 32) | read32(p + offset);
+			b = (read32(p + len - 4) << 32) | read32(p + len - 4 - offset);
+		}
+		else if (len > 0)
+		{
+			a = read1To3(p, len);
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
+	}
+	else
+	{
+		size_t remaining = len;
+		if (remaining > 48)
+		{
+			uint64_t lane1 = seed;
+			uint64_t lane2 = seed;
+			do
+			{
+				seed = hashMix(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+				lane1 = hashMix(read64(p + 16) ^ SECRET2, read64(p + 24) ^ lane1);
+				lane2 = hashMix(read64(p + 32) ^ SECRET3, read64(p + 40) ^ lane2);
+				p += 48;
+				remaining -= 48;
+			} while (remaining > 48);
+			seed ^= lane1 ^ lane2;
+		}
+		while (remaining > 16)
+		{
+			seed = hashMix(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+			p += 16;
+			remaining -= 16;
+		}
+		a = read64(p + remaining - 16);
+		b = read64(p + remaining - 8);
+	}
+
+	uint64_t low;
+	const uint64_t high = mulHigh64(a ^ SECRET1, b ^ seed, low);
+	return hashMix(low ^ SECRET0 ^ len, high ^ SECRET1);
+}
+
+/*
+*	Default hash of the hash tables, see the top of this file.
+*/
+template<typename K, typename Enable = void>
+struct FastHash
+{
+	size_t operator()(const K& key) const
+	{
+		return static_cast<size_t>(hashMix(static_cast<uint64_t>(std::hash<K>{}(key)) ^ hash_detail::SECRET0, hash_detail::SECRET1));
+	}
+};
+
+template<typename K>
+struct FastHash<K, typename std::enable_if<std::is_integral<K>::value || std::is_enum<K>::value || std::is_pointer<K>::value>::type>
+{
+	size_t operator()(const K key) const
+	{
+		uint64_t bits = 0;
+		std::memcpy(&bits, &key, sizeof(key) < sizeof(bits) ? sizeof(key) : sizeof(bits));
+		return static_cast<size_t>(hashMix(bits ^ hash_detail::SECRET0, hash_detail::SECRET1));
+	}
+};
+
+/*
+*	Strings are hashed as bytes, so std::string, std::string_view and const char* keys of the
+*	same text hash equal. is_transparent lets the tables look them up without building a K.
+*/
+template<>
+struct FastHash<std::string>
+{
+	using is_transparent = void;
+
+	size_t operator()(const std::string_view key) const
+	{
+		return static_cast<size_t>(hashBytes(key.data(), key.size()));
+	}
+};
+
+template<>
+struct FastHash<std::string_view> : FastHash<std::string>
+{
+};
+
+/*
+*	True when both Hash and KeyEqual declare is_transparent, i.e. they accept any key type that
+*	is comparable to the stored one (heterogeneous lookup).
+*/
+template<typename Hash, typename KeyEqual, typename = void>
+struct IsTransparentLookup : std::false_type
+{
+};
+
+template<typename Hash, typename KeyEqual>
+struct IsTransparentLookup<Hash, KeyEqual, std::void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>> : std::true_type
+{
+};
+
+/*
+*	Power of two bucket counts: multiply by 2^64 / golden ratio and keep the top log2(buckets)
+*	bits, which depend on all bits of the hash.
+*/
+struct FibonacciReducer
+{
+	static unsigned shiftFor(const size_t powerOfTwoBuckets)
+	{
+		unsigned bits = 0;
+		while ((size_t(1) << bits) < powerOfTwoBuckets)
+		{
+			++bits;
+		}
+		return 64 - bits;
+	}
+
+	// at least two buckets, a shift by 64 is undefined
+	static size_t reduce(const size_t hash, const unsigned shift)
+	{
+		return static_cast<size_t>((static_cast<uint64_t>(hash) * 11400714819323198485ull) >> shift);
+	}
+};
+
+/*
+*	Any bucket count: maps the hash onto [0, buckets) with (hash * buckets) >> 64 instead of a
+*	modulo. That picks the bucket from the high bits, so the hash is first scrambled with the
+*	same Fibonacci multiply to move the low bits up (std::hash of an integer has no high bits).
+*/
+struct RangeReducer
+{
+	static size_t reduce(const size_t hash, const size_t buckets)
+	{
+		uint64_t low;
+		const uint64_t scrambled = static_cast<uint64_t>(hash) * 11400714819323198485ull;
+		return static_cast<size_t>(mulHigh64(scrambled, static_cast<uint64_t>(buckets), low));
+	}
+};
+
+/*
+*	Bucket/probe length distribution of a hash table, used to judge hash quality on real key sets.
+*	For chaining tables a length is the number of values in a bin, for open addressing tables it is
+*	the probe distance of an entry from its home slot.
+*/
+struct HashDistributionStats
+{
+	size_t buckets = 0;		 // bins or slots
+	size_t entries = 0;		 // stored values
+	size_t emptyBuckets = 0; // bins or slots without any value
+	size_t maxLength = 0;	 // longest chain / probe distance
+	double meanLength = 0;
+	double variance = 0;
+
+	double emptyRatio() const
+	{
+		return buckets == 0 ? 0.0 : static_cast<double>(emptyBuckets) / static_cast<double>(buckets);
+	}
+
+	void print(const char* lengthName) const
+	{
+		std::cout << "Buckets: " << buckets << "\t" << "Entries: " << entries << "\n";
+		std::cout << "Empty buckets: " << emptyBuckets << " (" << emptyRatio() * 100.0 << "%)\n";
+		std::cout << "Max " << lengthName << ": " << maxLength << "\n";
+		std::cout << "Mean " << lengthName << ": " << meanLength << "\t" << "Variance: " << variance << std::endl;
+	}
+};
@@ -6,23 +6,50 @@
 #include <memory>
 #include <functional>
 #include "../LinkedList/LinkedList.h"
+#include "HashPolicies.h"
 
-template<typename K, typename V>
+/*
+*	Legacy chaining mode: every bin is a heap allocated LinkedList of values and keys are not
+*	stored, so colliding keys share one bin. See FlatHashTable for the open-addressing engine.
+*	Hash may be any hash functor; the bin is picked with a multiply (RangeReducer) instead of a
+*	modulo, so the capacity doesn't have to be a power of two.
+*	With a transparent Hash (FastHash<std::string> is one) get and deleteKey also take a
+*	std::string_view or const char* without building a temporary K.
+*	The bins and their nodes are allocated with Allocator, e.g. a PoolAllocator shared by all bins.
+*/
+template<typename K, typename V, typename Hash = FastHash<K>, typename Allocator = std::allocator<V>>
 class HashTable
 {
 public:
-	HashTable(const size_t capacity)
+	using Bin = LinkedList<V, Allocator>;
+
+private:
+	using BinAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Bin>;
+	using BinAllocatorTraits = std::allocator_traits<BinAllocator>;
+
+private:
+	// K itself, or any key type if Hash is transparent (keys are not stored, so only hashing matters)
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, K>::value || IsTransparentLookup<Hash, std::equal_to<>>::value>::type;
+
+public:
+	HashTable(const size_t capacity, const Allocator& allocator = Allocator())
 		: 
 		capacity(capacity),
-		hashTable(new LinkedList<V>*[capacity]())
+		hashTable(new Bin*[capacity]()),
+		binAllocator(allocator)
 	{
 	}
 
 	~HashTable()
 	{
+		releasePoolIfOwned();
 		for (size_t i = 0; i < capacity; ++i)
 		{
-			delete hashTable[i];
+			if (hashTable[i] != nullptr)
+			{
+				destroyBin(hashTable[i]);
+			}
 		}
 		delete[] hashTable;
 	}
@@ -36,37 +63,57 @@ public:
 
 		if (hashTable[idx] == nullptr)
 		{
-			hashTable[idx] = new LinkedList<V>(value);
+			hashTable[idx] = createBin(value);
 		}
 		else
 		{
-			static_cast<LinkedList<V>*>(hashTable[idx])->insertAtHead(value);
+			hashTable[idx]->insertAtHead(value);
 		}
 	}
 	
-	LinkedList<V>& get(const K& key)
+	Bin& get(const K& key)
+	{
+		return get<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	Bin& get(const Key& key)
 	{
 		const auto idx = hashFunc(key);
 		return *hashTable[idx];
 	}
 
+	/*
+	*	Drops the whole bin of key: keys are not stored, so colliding keys can't be told apart
+	*	and go with it. FlatHashTable::erase / erase_if remove single entries.
+	*/
 	void deleteKey(const K& key)
+	{
+		deleteKey<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	void deleteKey(const Key& key)
 	{
 		const auto idx = hashFunc(key);
-		delete hashTable[idx];
-		hashTable[idx] = nullptr;
+		if (hashTable[idx] != nullptr)
+		{
+			destroyBin(hashTable[idx]);
+			hashTable[idx] = nullptr;
+		}
 	}
 
-	size_t hashFunc(const K& key)
+	template<typename Key>
+	size_t hashFunc(const Key& key)
 	{
-		return std::hash<K>{}(key) % capacity;
+		return RangeReducer::reduce(Hash{}(key), capacity);
 	}
 
 	void printBinsInfo() const
 	{
 		for (size_t i = 0; i < capacity; ++i)
 		{
-			const auto ll = static_cast<LinkedList<V>*>(hashTable[i]);
+			const auto ll = hashTable[i];
 			if (ll != nullptr)
 			{
 				std::cout << "Bin: " << i << "\t" << "Values: " << ll->getSize() << std::endl;
@@ -76,9 +123,80 @@ public:
 				std::cout << "[UNUSED] Bin: " << i << "\t" << "Values: 0" << std::endl;
 			}
 		}
+		getDistributionStats().print("chain length");
+	}
+
+	HashDistributionStats getDistributionStats() const
+	{
+		HashDistributionStats stats;
+		stats.buckets = capacity;
+		if (capacity == 0)
+		{
+			return stats;
+		}
+
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			const size_t length = hashTable[i] != nullptr ? hashTable[i]->getSize() : 0;
+			stats.entries += length;
+			stats.emptyBuckets += length == 0 ? 1 : 0;
+			stats.maxLength = length > stats.maxLength ? length : stats.maxLength;
+		}
+
+		stats.meanLength = static_cast<double>(stats.entries) / static_cast<double>(capacity);
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			const double diff = (hashTable[i] != nullptr ? static_cast<double>(hashTable[i]->getSize()) : 0.0) - stats.meanLength;
+			stats.variance += diff * diff;
+		}
+		stats.variance /= static_cast<double>(capacity);
+		return stats;
+	}
+
+private:
+	Bin* createBin(const V& value)
+	{
+		Bin* bin = BinAllocatorTraits::allocate(binAllocator, 1);
+		try
+		{
+			BinAllocatorTraits::construct(binAllocator, bin, value, Allocator(binAllocator));
+		}
+		catch (...)
+		{
+			BinAllocatorTraits::deallocate(binAllocator, bin, 1);
+			throw;
+		}
+		return bin;
+	}
+
+	void destroyBin(Bin* bin)
+	{
+		BinAllocatorTraits::destroy(binAllocator, bin);
+		BinAllocatorTraits::deallocate(binAllocator, bin, 1);
+	}
+
+	/*
+	*	Every bin holds a handle to the pool. If nothing but this table does, the pool dies with
+	*	the table, so the bins can skip freeing their nodes one by one.
+	*/
+	void releasePoolIfOwned()
+	{
+		if constexpr (IsPoolAllocator<Allocator>::value)
+		{
+			size_t binCount = 0;
+			for (size_t i = 0; i < capacity; ++i)
+			{
+				binCount += hashTable[i] != nullptr ? 1 : 0;
+			}
+			if (static_cast<size_t>(binAllocator.getPool().use_count()) == binCount + 1)
+			{
+				binAllocator.getPool()->beginRelease();
+			}
+		}
 	}
 
 private:
 	size_t capacity;
-	LinkedList<V>** hashTable;
+	Bin** hashTable;
+	BinAllocator binAllocator;
 };
\ No newline at end of file
@@ -0,0 +1 @@
+#include <HashTableSnapshot.h>
\ No newline at end of file
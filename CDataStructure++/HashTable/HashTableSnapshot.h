@@ -0,0 +1,235 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "HashPolicies.h"
+
+/*
+*	On-disk snapshot of a hash table that MappedHashTable queries in place, without rebuilding.
+*
+*	File layout (version 1), all integers in the byte order of the writer:
+*		SnapshotHeader				 64 bytes
+*		slots[slotCount]			 open addressing with linear probing, slotCount a power of two
+*		string heap[stringHeapSize]	 key bytes of string keyed snapshots, slots refer to them by offset
+*
+*	A slot is empty when its tag is 0, otherwise the tag is the key hash with the top bit set.
+*	The hash is hashBytes over the key bytes (the characters for string keys) and never the Hash
+*	of the table, so a snapshot can be read by any build on a machine with the same byte order
+*	and struct layout (both are recorded in the header and checked when mapping).
+*
+*	Fixed size keys must be trivially copyable without padding bytes (their bytes are hashed and
+*	compared), values must be trivially copyable.
+*/
+struct SnapshotHeader
+{
+	char magic[8];			 // SNAPSHOT_MAGIC
+	uint32_t version;		 // SNAPSHOT_VERSION
+	uint32_t byteOrder;		 // SNAPSHOT_BYTE_ORDER as seen by the writer
+	uint32_t keyKind;		 // SNAPSHOT_FIXED_KEYS or SNAPSHOT_STRING_KEYS
+	uint32_t slotSize;		 // sizeof of the slot struct
+	uint32_t keySize;		 // sizeof(K), 0 for string keys
+	uint32_t valueSize;		 // sizeof(V)
+	uint64_t slotCount;
+	uint64_t entryCount;
+	uint64_t stringHeapSize; // bytes behind the slots
+	uint64_t reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "the snapshot header must stay 64 bytes");
+
+constexpr char SNAPSHOT_MAGIC[8] = { 'C', 'D', 'S', 'S', 'N', 'A', 'P', '\0' };
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+constexpr uint32_t SNAPSHOT_FIXED_KEYS = 1;
+constexpr uint32_t SNAPSHOT_STRING_KEYS = 2;
+constexpr uint64_t SNAPSHOT_OCCUPIED = 1ull << 63;
+
+template<typename K, typename V>
+struct FixedKeySnapshotSlot
+{
+	uint64_t tag;
+	K key;
+	V value;
+};
+
+template<typename V>
+struct StringKeySnapshotSlot
+{
+	uint64_t tag;
+	uint64_t keyOffset; // into the string heap
+	uint64_t keyLength;
+	V value;
+};
+
+/*
+*	Probing and file writing shared by the snapshot writers and MappedHashTable.
+*/
+struct SnapshotLayout
+{
+	// at most 3/4 of the slots are used
+	static uint64_t slotCountFor(const uint64_t entryCount)
+	{
+		uint64_t slotCount = 16;
+		while (slotCount < entryCount + entryCount / 3 + 1)
+		{
+			slotCount <<= 1;
+		}
+		return slotCount;
+	}
+
+	static uint64_t tagOf(const void* keyBytes, const size_t keyLength)
+	{
+		return hashBytes(keyBytes, keyLength) | SNAPSHOT_OCCUPIED;
+	}
+
+	static size_t homeIndex(const uint64_t tag, const unsigned shift)
+	{
+		return FibonacciReducer::reduce(static_cast<size_t>(tag), shift);
+	}
+
+	template<typename SlotType>
+	static size_t findFree(const std::vector<SlotType>& slotArray, const uint64_t tag, const unsigned tableShift)
+	{
+		const size_t mask = slotArray.size() - 1;
+		size_t idx = homeIndex(tag, tableShift);
+		while (slotArray[idx].tag != 0)
+		{
+			idx = (idx + 1) & mask;
+		}
+		return idx;
+	}
+
+	template<typename SlotType>
+	static void write(
+		const std::string& path,
+		const uint32_t keyKind,
+		const uint32_t keySize,
+		const uint32_t valueSize,
+		const std::vector<SlotType>& slotArray,
+		const uint64_t entryCount,
+		const std::vector<char>& stringHeap)
+	{
+		SnapshotHeader header{};
+		std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+		header.version = SNAPSHOT_VERSION;
+		header.byteOrder = SNAPSHOT_BYTE_ORDER;
+		header.keyKind = keyKind;
+		header.slotSize = sizeof(SlotType);
+		header.keySize = keySize;
+		header.valueSize = valueSize;
+		header.slotCount = slotArray.size();
+		header.entryCount = entryCount;
+		header.stringHeapSize = stringHeap.size();
+
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+		if (file == nullptr)
+		{
+			throw std::runtime_error("cannot open snapshot file for writing: " + path);
+		}
+
+		const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+			&& std::fwrite(slotArray.data(), sizeof(SlotType), slotArray.size(), file) == slotArray.size()
+			&& (stringHeap.empty() || std::fwrite(stringHeap.data(), 1, stringHeap.size(), file) == stringHeap.size());
+		if (std::fclose(file) != 0 || !written)
+		{
+			throw std::runtime_error("cannot write snapshot file: " + path);
+		}
+	}
+};
+
+/*
+*	Collects the entries of a table and writes them as a snapshot. The whole file is built in
+*	memory and then written front to back in one sequential pass.
+*/
+template<typename K, typename V>
+class HashTableSnapshot
+{
+public:
+	using Slot = FixedKeySnapshotSlot<K, V>;
+
+	static_assert(std::is_trivially_copyable<K>::value && std::has_unique_object_representations<K>::value,
+		"snapshot keys must be std::string or trivially copyable without padding");
+	static_assert(std::is_trivially_copyable<V>::value, "snapshot values must be trivially copyable");
+
+public:
+	explicit HashTableSnapshot(const size_t entryCount)
+		:
+		slots(SnapshotLayout::slotCountFor(entryCount)),
+		shift(FibonacciReducer::shiftFor(slots.size())),
+		count(0)
+	{
+	}
+
+	// Keys have to be unique, they come from a table
+	void add(const K& key, const V& value)
+	{
+		const uint64_t tag = SnapshotLayout::tagOf(&key, sizeof(K));
+		Slot& slot = slots[SnapshotLayout::findFree(slots, tag, shift)];
+		slot.tag = tag;
+		slot.key = key;
+		slot.value = value;
+		++count;
+	}
+
+	void save(const std::string& path) const
+	{
+		SnapshotLayout::write(path, SNAPSHOT_FIXED_KEYS, sizeof(K), sizeof(V), slots, count, std::vector<char>());
+	}
+
+private:
+	std::vector<Slot> slots;
+	unsigned shift;
+	uint64_t count;
+};
+
+/*
+*	String keys: the characters go to the string heap, the slot keeps offset and length.
+*/
+template<typename V>
+class HashTableSnapshot<std::string, V>
+{
+public:
+	using Slot = StringKeySnapshotSlot<V>;
+
+	static_assert(std::is_trivially_copyable<V>::value, "snapshot values must be trivially copyable");
+
+public:
+	explicit HashTableSnapshot(const size_t entryCount)
+		:
+		slots(SnapshotLayout::slotCountFor(entryCount)),
+		shift(FibonacciReducer::shiftFor(slots.size())),
+		count(0)
+	{
+	}
+
+	void add(const std::string_view key, const V& value)
+	{
+		const uint64_t tag = SnapshotLayout::tagOf(key.data(), key.size());
+		Slot& slot = slots[SnapshotLayout::findFree(slots, tag, shift)];
+		slot.tag = tag;
+		slot.keyOffset = stringHeap.size();
+		slot.keyLength = key.size();
+		slot.value = value;
+		stringHeap.insert(stringHeap.end(), key.begin(), key.end());
+		++count;
+	}
+
+	void save(const std::string& path) const
+	{
+		SnapshotLayout::write(path, SNAPSHOT_STRING_KEYS, 0, sizeof(V), slots, count, stringHeap);
+	}
+
+private:
+	std::vector<Slot> slots;
+	unsigned shift;
+	uint64_t count;
+	std::vector<char> stringHeap;
+};
@@ -0,0 +1 @@
+#include <LockFreeHashTable.h>
\ No newline at end of file
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include "../LinkedList/LockFreeLinkedList.h"
+#include "HashPolicies.h"
+
+/*
+*	Lock-free hash table for read-mostly workloads, built as a split-ordered list (Shalev & Shavit).
+*
+*	All entries live in one LockFreeLinkedList sorted by their bit-reversed hash. A bucket is only
+*	a pointer to a sentinel node inside that list, so doubling the bucket count never moves an
+*	entry: the new bucket's sentinel is lazily spliced in between the entries of its parent bucket
+*	the first time somebody uses it.
+*
+*	get/contains are lock-free and run under an epoch pin. Once their bucket is initialized they
+*	only load pointers (no CAS, no shared writes), so readers scale with the core count. The first
+*	access to a bucket after the table grew, by a reader as well, lazily initializes it: it
+*	allocates the bucket's sentinel (and the segment of bucket slots, if that is missing too) and
+*	CASes them in. Erased nodes are freed through the EpochManager.
+*	K and V must be default constructible (sentinel nodes carry an empty entry) and values are
+*	immutable once inserted.
+*	Keys are compared with KeyEqual. When Hash and KeyEqual are both transparent (the defaults
+*	for std::string keys) get/contains/erase take any key comparable to K, e.g. a
+*	std::string_view, without building a temporary K.
+*/
+template<typename K, typename V, typename Hash = FastHash<K>, typename KeyEqual = std::equal_to<>>
+class LockFreeHashTable
+{
+private:
+	// K itself, or any key type if the lookup is transparent
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, K>::value || IsTransparentLookup<Hash, KeyEqual>::value>::type;
+
+	struct SplitOrderedEntry
+	{
+		uint64_t soKey; // bit-reversed hash; odd for entries, even for bucket sentinels
+		K key;
+		V value;
+	};
+
+	template<typename Key>
+	struct Probe
+	{
+		uint64_t soKey;
+		const Key* key;
+	};
+
+	// Entries with the same split-order key (full hash collision) are kept next to each other
+	// and told apart by comparing the keys.
+	struct SplitOrdering
+	{
+		template<typename Key>
+		static bool precedes(const SplitOrderedEntry& nodeData, const Probe<Key>& target)
+		{
+			return nodeData.soKey < target.soKey
+				|| (nodeData.soKey == target.soKey && target.key != nullptr && !KeyEqual{}(nodeData.key, *target.key));
+		}
+
+		template<typename Key>
+		static bool equals(const SplitOrderedEntry& nodeData, const Probe<Key>& target)
+		{
+			return nodeData.soKey == target.soKey && (target.key == nullptr || KeyEqual{}(nodeData.key, *target.key));
+		}
+	};
+
+	using List = LockFreeLinkedList<SplitOrderedEntry, SplitOrdering>;
+	using NodeType = typename List::NodeType;
+	using Bucket = std::atomic<NodeType*>;
+
+public:
+	LockFreeHashTable()
+		:
+		bucketCount(INITIAL_BUCKETS),
+		count(0)
+	{
+		for (auto& segment : segments)
+		{
+			segment.store(nullptr, std::memory_order_relaxed);
+		}
+		// bucket 0 is the list head itself, soKey 0 sorts before everything
+		bucketSlot(0).store(list.getHead(), std::memory_order_relaxed);
+	}
+
+	// Delete constructors which may cause headache and bugs
+	LockFreeHashTable(const LockFreeHashTable&) = delete;
+	LockFreeHashTable(LockFreeHashTable&&) = delete;
+
+	~LockFreeHashTable()
+	{
+		// the list deletes every entry and sentinel node
+		for (auto& segment : segments)
+		{
+			delete[] segment.load(std::memory_order_relaxed);
+		}
+	}
+
+	/*
+	*	Inserts the pair if the key is not present yet. Returns false when the key already exists.
+	*/
+	bool insert(const K& key, const V& value)
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		const uint64_t hash = hashFunc(key);
+		const uint64_t soKey = entryKey(hash);
+
+		NodeType* sentinel = bucketFor(hash);
+		NodeType* node = new NodeType(SplitOrderedEntry{ soKey, key, value });
+		if (list.insertFrom(sentinel, node, Probe<K>{ soKey, &node->data.key }) != node)
+		{
+			delete node;
+			return false;
+		}
+
+		const size_t newCount = count.fetch_add(1, std::memory_order_relaxed) + 1;
+		size_t buckets = bucketCount.load(std::memory_order_relaxed);
+		if (newCount > buckets * MAX_LOAD_FACTOR && buckets < MAX_BUCKETS)
+		{
+			// only publishes the bigger size, the new buckets get their sentinel on first use
+			bucketCount.compare_exchange_strong(buckets, buckets * 2, std::memory_order_relaxed);
+		}
+		return true;
+	}
+
+	std::optional<V> get(const K& key) const
+	{
+		return get<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	std::optional<V> get(const Key& key) const
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		const NodeType* node = findNode(key);
+		if (node == nullptr)
+		{
+			return std::nullopt;
+		}
+		return node->data.value;
+	}
+
+	bool contains(const K& key) const
+	{
+		return contains<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool contains(const Key& key) const
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		return findNode(key) != nullptr;
+	}
+
+	bool erase(const K& key)
+	{
+		return erase<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool erase(const Key& key)
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		const uint64_t hash = hashFunc(key);
+		if (list.removeFrom(bucketFor(hash), Probe<Key>{ entryKey(hash), &key }))
+		{
+			count.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	size_t size() const
+	{
+		return count.load(std::memory_order_relaxed);
+	}
+
+	size_t getCapacity() const
+	{
+		return bucketCount.load(std::memory_order_relaxed);
+	}
+
+	// a custom Hash may be weak in the low bits (std::hash is the identity for integers), so spread
+	// the bits before the low ones pick the bucket
+	static uint64_t hashFunc(const K& key)
+	{
+		return hashFunc<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	static uint64_t hashFunc(const Key& key)
+	{
+		const uint64_t h = static_cast<uint64_t>(Hash{}(key)) * 11400714819323198485ull;
+		return h ^ (h >> 32);
+	}
+
+private:
+	static constexpr size_t INITIAL_BUCKETS = 16;
+	static constexpr size_t MAX_LOAD_FACTOR = 2;
+	// buckets live in lazily allocated segments so the bucket array never has to be copied
+	static constexpr size_t SEGMENT_SIZE = 4096;
+	static constexpr size_t SEGMENT_COUNT = 4096;
+	static constexpr size_t MAX_BUCKETS = SEGMENT_SIZE * SEGMENT_COUNT;
+
+	static uint64_t reverseBits(uint64_t value)
+	{
+		value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+		value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+		value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+		value = ((value >> 8) & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+		value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+		return (value >> 32) | (value << 32);
+	}
+
+	// the top bit of the hash is dropped so the reversed key can carry the "regular entry" bit
+	static uint64_t entryKey(const uint64_t hash)
+	{
+		return reverseBits(hash & ~(1ull << 63)) | 1;
+	}
+
+	static uint64_t sentinelKey(const size_t bucket)
+	{
+		return reverseBits(static_cast<uint64_t>(bucket));
+	}
+
+	Bucket& bucketSlot(const size_t bucket) const
+	{
+		std::atomic<Bucket*>& segmentRef = segments[bucket / SEGMENT_SIZE];
+		Bucket* segment = segmentRef.load(std::memory_order_acquire);
+		if (segment == nullptr)
+		{
+			Bucket* newSegment = new Bucket[SEGMENT_SIZE];
+			for (size_t i = 0; i < SEGMENT_SIZE; ++i)
+			{
+				newSegment[i].store(nullptr, std::memory_order_relaxed);
+			}
+
+			if (segmentRef.compare_exchange_strong(segment, newSegment, std::memory_order_acq_rel))
+			{
+				segment = newSegment;
+			}
+			else
+			{
+				delete[] newSegment; // another thread won, segment now holds its array
+			}
+		}
+		return segment[bucket % SEGMENT_SIZE];
+	}
+
+	NodeType* bucketFor(const uint64_t hash) const
+	{
+		const size_t bucket = static_cast<size_t>(hash & (bucketCount.load(std::memory_order_relaxed) - 1));
+		NodeType* sentinel = bucketSlot(bucket).load(std::memory_order_acquire);
+		return sentinel != nullptr ? sentinel : initializeBucket(bucket);
+	}
+
+	/*
+	*	Splices the sentinel of a bucket into the list, right behind the sentinel of its parent
+	*	bucket (the bucket index without its highest set bit), initializing that one first.
+	*/
+	NodeType* initializeBucket(const size_t bucket) const
+	{
+		size_t parent = bucket;
+		for (size_t bit = 1; bit <= bucket; bit <<= 1)
+		{
+			if ((bucket & bit) != 0)
+			{
+				parent = bucket & ~bit; // ends up with the highest set bit cleared
+			}
+		}
+
+		NodeType* parentSentinel = bucketSlot(parent).load(std::memory_order_acquire);
+		if (parentSentinel == nullptr)
+		{
+			parentSentinel = initializeBucket(parent);
+		}
+
+		const uint64_t soKey = sentinelKey(bucket);
+		NodeType* sentinel = new NodeType(SplitOrderedEntry{ soKey, K(), V() });
+		NodeType* linked = list.insertFrom(parentSentinel, sentinel, Probe<K>{ soKey, nullptr });
+		if (linked != sentinel)
+		{
+			delete sentinel; // another thread spliced the same sentinel in first
+		}
+
+		bucketSlot(bucket).store(linked, std::memory_order_release);
+		return linked;
+	}
+
+	template<typename Key>
+	const NodeType* findNode(const Key& key) const
+	{
+		const uint64_t hash = hashFunc(key);
+		return list.findFrom(bucketFor(hash), Probe<Key>{ entryKey(hash), &key });
+	}
+
+private:
+	mutable List list;
+	mutable std::atomic<Bucket*> segments[SEGMENT_COUNT];
+	std::atomic<size_t> bucketCount;
+	std::atomic<size_t> count;
+};
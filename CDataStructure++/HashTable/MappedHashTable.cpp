@@ -0,0 +1 @@
+#include <MappedHashTable.h>
\ No newline at end of file
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "HashTableSnapshot.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+*	Read-only memory mapping of a whole file. Nothing is read up front: pages are faulted in
+*	(and cached by the OS) the first time a lookup touches them.
+*/
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& path)
+		:
+		data(nullptr),
+		length(0)
+	{
+#if defined(_WIN32)
+		fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("cannot open snapshot file: " + path);
+		}
+
+		LARGE_INTEGER fileSize;
+		mappingHandle = nullptr;
+		if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+		{
+			mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		if (mappingHandle == nullptr)
+		{
+			CloseHandle(fileHandle);
+			throw std::runtime_error("cannot map snapshot file: " + path);
+		}
+
+		data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr)
+		{
+			CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+			throw std::runtime_error("cannot map snapshot file: " + path);
+		}
+		length = static_cast<size_t>(fileSize.QuadPart);
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("cannot open snapshot file: " + path);
+		}
+
+		struct stat fileStat;
+		void* mapping = MAP_FAILED;
+		if (::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+		{
+			mapping = ::mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd); // the mapping keeps the file alive
+		if (mapping == MAP_FAILED)
+		{
+			throw std::runtime_error("cannot map snapshot file: " + path);
+		}
+
+		// lookups jump around, read-ahead would only pull in pages nobody asked for
+		::madvise(mapping, static_cast<size_t>(fileStat.st_size), MADV_RANDOM);
+		data = static_cast<const char*>(mapping);
+		length = static_cast<size_t>(fileStat.st_size);
+#endif
+	}
+
+	// Delete constructors which may cause headache and bugs
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) = delete;
+
+	~MappedFile()
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(data);
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+#else
+		::munmap(const_cast<char*>(data), length);
+#endif
+	}
+
+	const char* getData() const
+	{
+		return data;
+	}
+
+	size_t getLength() const
+	{
+		return length;
+	}
+
+private:
+	const char* data;
+	size_t length;
+#if defined(_WIN32)
+	HANDLE fileHandle;
+	HANDLE mappingHandle;
+#endif
+};
+
+/*
+*	Checks that the mapped file is a snapshot of the expected key/value layout and that it is not
+*	truncated. Throws std::runtime_error otherwise.
+*/
+inline SnapshotHeader validateSnapshotHeader(
+	const MappedFile& mappedFile,
+	const uint32_t keyKind,
+	const uint32_t keySize,
+	const uint32_t slotSize,
+	const uint32_t valueSize)
+{
+	SnapshotHeader fileHeader;
+	if (mappedFile.getLength() < sizeof(fileHeader))
+	{
+		throw std::runtime_error("snapshot file is too small");
+	}
+	std::memcpy(&fileHeader, mappedFile.getData(), sizeof(fileHeader));
+
+	if (std::memcmp(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+	{
+		throw std::runtime_error("not a hash table snapshot");
+	}
+	if (fileHeader.version != SNAPSHOT_VERSION)
+	{
+		throw std::runtime_error("unsupported snapshot version " + std::to_string(fileHeader.version));
+	}
+	if (fileHeader.byteOrder != SNAPSHOT_BYTE_ORDER)
+	{
+		throw std::runtime_error("snapshot was written with a different byte order");
+	}
+	if (fileHeader.keyKind != keyKind || fileHeader.keySize != keySize || fileHeader.slotSize != slotSize || fileHeader.valueSize != valueSize)
+	{
+		throw std::runtime_error("snapshot was written for different key/value types");
+	}
+
+	const uint64_t payload = mappedFile.getLength() - sizeof(fileHeader);
+	if (fileHeader.slotCount < 2 || (fileHeader.slotCount & (fileHeader.slotCount - 1)) != 0
+		|| fileHeader.entryCount >= fileHeader.slotCount
+		|| fileHeader.slotCount > payload / slotSize
+		|| payload - fileHeader.slotCount * slotSize != fileHeader.stringHeapSize)
+	{
+		throw std::runtime_error("snapshot file is corrupt or truncated");
+	}
+	return fileHeader;
+}
+
+/*
+*	Read-only hash table served straight from a snapshot file (see HashTableSnapshot.h), written
+*	by FlatHashTable::save or StringHashTable::save. Opening only maps and validates the header,
+*	so it is O(1) no matter how many entries the file holds; a lookup hashes the key and probes
+*	the mapped slots in place. find returns pointers into the mapping, valid as long as the
+*	MappedHashTable lives.
+*/
+template<typename K, typename V>
+class MappedHashTable
+{
+public:
+	using Slot = typename HashTableSnapshot<K, V>::Slot;
+
+public:
+	explicit MappedHashTable(const std::string& path)
+		:
+		file(path),
+		header(validateSnapshotHeader(file, SNAPSHOT_FIXED_KEYS, sizeof(K), sizeof(Slot), sizeof(V))),
+		slots(reinterpret_cast<const Slot*>(file.getData() + sizeof(SnapshotHeader))),
+		shift(FibonacciReducer::shiftFor(header.slotCount))
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	MappedHashTable(const MappedHashTable&) = delete;
+	MappedHashTable(MappedHashTable&&) = delete;
+
+	const V* find(const K& key) const
+	{
+		const uint64_t tag = SnapshotLayout::tagOf(&key, sizeof(K));
+		const size_t mask = header.slotCount - 1;
+		size_t idx = SnapshotLayout::homeIndex(tag, shift);
+		// a valid snapshot always has an empty slot, a damaged one may not: never probe more than every slot once
+		for (size_t probes = 0; probes < header.slotCount && slots[idx].tag != 0; ++probes, idx = (idx + 1) & mask)
+		{
+			if (slots[idx].tag == tag && std::memcmp(&slots[idx].key, &key, sizeof(K)) == 0)
+			{
+				return &slots[idx].value;
+			}
+		}
+		return nullptr;
+	}
+
+	bool contains(const K& key) const
+	{
+		return find(key) != nullptr;
+	}
+
+	size_t size() const
+	{
+		return static_cast<size_t>(header.entryCount);
+	}
+
+	size_t getCapacity() const
+	{
+		return static_cast<size_t>(header.slotCount);
+	}
+
+private:
+	MappedFile file;
+	SnapshotHeader header;
+	const Slot* slots;
+	unsigned shift;
+};
+
+/*
+*	String keyed snapshot: slots hold the offset and length of their key in the string heap.
+*/
+template<typename V>
+class MappedHashTable<std::string, V>
+{
+public:
+	using Slot = typename HashTableSnapshot<std::string, V>::Slot;
+
+public:
+	explicit MappedHashTable(const std::string& path)
+		:
+		file(path),
+		header(validateSnapshotHeader(file, SNAPSHOT_STRING_KEYS, 0, sizeof(Slot), sizeof(V))),
+		slots(reinterpret_cast<const Slot*>(file.getData() + sizeof(SnapshotHeader))),
+		stringHeap(file.getData() + sizeof(SnapshotHeader) + header.slotCount * sizeof(Slot)),
+		shift(FibonacciReducer::shiftFor(header.slotCount))
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	MappedHashTable(const MappedHashTable&) = delete;
+	MappedHashTable(MappedHashTable&&) = delete;
+
+	const V* find(const std::string_view key) const
+	{
+		const uint64_t tag = SnapshotLayout::tagOf(key.data(), key.size());
+		const size_t mask = header.slotCount - 1;
+		size_t idx = SnapshotLayout::homeIndex(tag, shift);
+		// same bound as the fixed-key find, a damaged snapshot may have no empty slot
+		for (size_t probes = 0; probes < header.slotCount && slots[idx].tag != 0; ++probes, idx = (idx + 1) & mask)
+		{
+			const Slot& slot = slots[idx];
+			if (slot.tag == tag && slot.keyLength == key.size()
+				&& slot.keyOffset + slot.keyLength <= header.stringHeapSize
+				&& std::memcmp(stringHeap + slot.keyOffset, key.data(), key.size()) == 0)
+			{
+				return &slot.value;
+			}
+		}
+		return nullptr;
+	}
+
+	bool contains(const std::string_view key) const
+	{
+		return find(key) != nullptr;
+	}
+
+	size_t size() const
+	{
+		return static_cast<size_t>(header.entryCount);
+	}
+
+	size_t getCapacity() const
+	{
+		return static_cast<size_t>(header.slotCount);
+	}
+
+private:
+	MappedFile file;
+	SnapshotHeader header;
+	const Slot* slots;
+	const char* stringHeap;
+	unsigned shift;
+};
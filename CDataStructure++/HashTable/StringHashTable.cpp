@@ -0,0 +1 @@
+#include <StringHashTable.h>
\ No newline at end of file
@@ -0,0 +1,620 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HashPolicies.h"
+#include "HashTableSnapshot.h"
+
+/*
+*	Robin Hood hash table (like FlatHashTable) specialized for string keys.
+*	A std::string key costs a heap allocation once it outgrows the small string buffer (15 bytes
+*	in libstdc++) and every compare has to follow its data pointer. Here a key of up to
+*	INLINE_CAPACITY (28) bytes is stored inline in the slot. Only longer keys are copied into one
+*	shared arena, and the slot keeps their length, their first 4 bytes and an arena offset.
+*
+*	Every slot also keeps 32 bits of the key hash. A lookup first compares that tag and then the
+*	length and 4 byte prefix as one 8 byte word, so a mismatching slot is almost always rejected
+*	without touching the rest of the key or the arena. The tag also yields the home slot, so
+*	growing never has to hash a key again.
+*
+*	Keys are passed as std::string_view (std::string and const char* convert implicitly), so Hash
+*	has to accept one.
+*	The bytes of erased long keys stay in the arena until a rebuild of the slot array compacts it
+*	(on growth, or on insert once more than half of the arena is garbage).
+*/
+template<typename V, typename Hash = FastHash<std::string>>
+class StringHashTable
+{
+public:
+	StringHashTable(const size_t capacity = MIN_CAPACITY)
+		:
+		capacity(roundUpToPowerOfTwo(capacity)),
+		shift(FibonacciReducer::shiftFor(this->capacity)),
+		count(0),
+		slots(allocateSlots(this->capacity)),
+		arenaGarbage(0)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	StringHashTable(const StringHashTable&) = delete;
+	StringHashTable(StringHashTable&&) = delete;
+
+	~StringHashTable()
+	{
+		destroyValues();
+		std::free(slots);
+	}
+
+	V* find(const std::string_view key)
+	{
+		const auto idx = findIndex(key);
+		return idx == NOT_FOUND ? nullptr : &slots[idx].value();
+	}
+
+	const V* find(const std::string_view key) const
+	{
+		const auto idx = findIndex(key);
+		return idx == NOT_FOUND ? nullptr : &slots[idx].value();
+	}
+
+	bool contains(const std::string_view key) const
+	{
+		return findIndex(key) != NOT_FOUND;
+	}
+
+	/*
+	*	Inserts the pair if the key is not present yet. Returns false (and leaves the stored
+	*	value untouched) when the key already exists.
+	*/
+	bool insert(const std::string_view key, const V& value)
+	{
+		const uint32_t tag = tagOf(key);
+		if (findIndex(key, tag) != NOT_FOUND)
+		{
+			return false;
+		}
+
+		growIfNeeded();
+		insertUnique(slots, capacity, shift, tag, makeKey(key), V(value));
+		++count;
+		return true;
+	}
+
+	/*
+	*	Inserts the pair or overwrites the value of an existing key.
+	*	Returns true if a new key was inserted, false if an existing value was assigned.
+	*/
+	bool insert_or_assign(const std::string_view key, const V& value)
+	{
+		const uint32_t tag = tagOf(key);
+		const auto idx = findIndex(key, tag);
+		if (idx != NOT_FOUND)
+		{
+			slots[idx].value() = value;
+			return false;
+		}
+
+		growIfNeeded();
+		insertUnique(slots, capacity, shift, tag, makeKey(key), V(value));
+		++count;
+		return true;
+	}
+
+	/*
+	*	Removes the key with backward-shift deletion, see FlatHashTable::erase.
+	*/
+	bool erase(const std::string_view key)
+	{
+		size_t idx = findIndex(key);
+		if (idx == NOT_FOUND)
+		{
+			return false;
+		}
+
+		if (!slots[idx].key.isInline())
+		{
+			arenaGarbage += slots[idx].key.length;
+		}
+		slots[idx].value().~V();
+		slots[idx].dist = EMPTY;
+		--count;
+
+		const size_t mask = capacity - 1;
+		size_t next = (idx + 1) & mask;
+		while (slots[next].dist > 1)
+		{
+			slots[idx].hashTag = slots[next].hashTag;
+			slots[idx].key = slots[next].key;
+			new (&slots[idx].storage) V(std::move(slots[next].value()));
+			slots[idx].dist = slots[next].dist - 1;
+			slots[next].value().~V();
+			slots[next].dist = EMPTY;
+
+			idx = next;
+			next = (next + 1) & mask;
+		}
+		return true;
+	}
+
+	/*
+	*	Removes every entry for which pred(key, value) returns true in one linear sweep, see
+	*	FlatHashTable::erase_if. key is a std::string_view. Returns the number of removed entries.
+	*/
+	template<typename Pred>
+	size_t erase_if(Pred pred)
+	{
+		const size_t mask = capacity - 1;
+
+		// count positions from an empty slot, so no cluster wraps around the start of the sweep
+		size_t start = 0;
+		while (slots[start].dist != EMPTY)
+		{
+			++start;
+		}
+
+		size_t removed = 0;
+		size_t firstFree = start + 1;
+		for (size_t pos = start + 1; pos <= start + capacity; ++pos)
+		{
+			Slot& slot = slots[pos & mask];
+			if (slot.dist == EMPTY)
+			{
+				firstFree = pos + 1;
+				continue;
+			}
+
+			if (pred(keyOf(slot.key), slot.value()))
+			{
+				if (!slot.key.isInline())
+				{
+					arenaGarbage += slot.key.length;
+				}
+				slot.value().~V();
+				slot.dist = EMPTY;
+				++removed;
+				continue;
+			}
+
+			const size_t home = pos - (slot.dist - 1);
+			const size_t target = firstFree > home ? firstFree : home;
+			if (target != pos)
+			{
+				Slot& destination = slots[target & mask];
+				destination.hashTag = slot.hashTag;
+				destination.key = slot.key;
+				new (&destination.storage) V(std::move(slot.value()));
+				destination.dist = static_cast<uint32_t>(target - home + 1);
+				slot.value().~V();
+				slot.dist = EMPTY;
+			}
+			firstFree = target + 1;
+		}
+		count -= removed;
+
+		// a bulk expiry is a good moment to drop the bytes of the erased long keys
+		if (arenaGarbage > arena.size() / 2 && arenaGarbage >= capacity)
+		{
+			rehash(capacity);
+		}
+		return removed;
+	}
+
+	/*
+	*	Keeps only the entries for which pred(key, value) returns true, see erase_if.
+	*/
+	template<typename Pred>
+	size_t retain(Pred pred)
+	{
+		return erase_if([&pred](const std::string_view key, V& value)
+			{
+				return !pred(key, value);
+			});
+	}
+
+	void clear()
+	{
+		destroyValues();
+		arena.clear();
+		arenaGarbage = 0;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return capacity;
+	}
+
+	float load_factor() const
+	{
+		return static_cast<float>(count) / static_cast<float>(capacity);
+	}
+
+	/*
+	*	Makes room for at least entryCount entries without growing again.
+	*/
+	void reserve(const size_t entryCount)
+	{
+		const size_t newCapacity = roundUpToPowerOfTwo(static_cast<size_t>(static_cast<float>(entryCount) / MAX_LOAD_FACTOR) + 1);
+		if (newCapacity > capacity)
+		{
+			rehash(newCapacity);
+		}
+	}
+
+	// Bytes of long keys in the arena, including those of erased keys that are not compacted yet
+	size_t getArenaSize() const
+	{
+		return arena.size();
+	}
+
+	/*
+	*	Calls func(key, value) for every stored entry in slot order, key is a std::string_view.
+	*/
+	template<typename Func>
+	void forEach(Func func) const
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (slots[i].dist != EMPTY)
+			{
+				func(keyOf(slots[i].key), slots[i].value());
+			}
+		}
+	}
+
+	/*
+	*	Writes the entries as a snapshot file that MappedHashTable<std::string, V> can map and
+	*	query without loading it. V has to be trivially copyable.
+	*	Throws std::runtime_error if the file can't be written.
+	*/
+	void save(const std::string& path) const
+	{
+		HashTableSnapshot<std::string, V> snapshot(size());
+		forEach([&snapshot](const std::string_view key, const V& value)
+			{
+				snapshot.add(key, value);
+			});
+		snapshot.save(path);
+	}
+
+	void printBinsInfo() const
+	{
+		size_t inlineKeys = 0;
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			inlineKeys += slots[i].dist != EMPTY && slots[i].key.isInline() ? 1 : 0;
+		}
+		std::cout << "Inline keys: " << inlineKeys << "\t" << "Arena keys: " << count - inlineKeys << "\n";
+		std::cout << "Arena bytes: " << arena.size() << " (" << arenaGarbage << " of erased keys)\n";
+		getDistributionStats().print("probe length");
+	}
+
+	HashDistributionStats getDistributionStats() const
+	{
+		HashDistributionStats stats;
+		stats.buckets = capacity;
+		stats.entries = count;
+		stats.emptyBuckets = capacity - count;
+		if (count == 0)
+		{
+			return stats;
+		}
+
+		double sum = 0;
+		double sumOfSquares = 0;
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (slots[i].dist != EMPTY)
+			{
+				const size_t probeLength = slots[i].dist - 1;
+				stats.maxLength = probeLength > stats.maxLength ? probeLength : stats.maxLength;
+				sum += static_cast<double>(probeLength);
+				sumOfSquares += static_cast<double>(probeLength) * static_cast<double>(probeLength);
+			}
+		}
+		stats.meanLength = sum / static_cast<double>(count);
+		stats.variance = sumOfSquares / static_cast<double>(count) - stats.meanLength * stats.meanLength;
+		return stats;
+	}
+
+private:
+	static constexpr size_t INLINE_CAPACITY = 28;
+	static constexpr size_t PREFIX_SIZE = 4;
+	static constexpr size_t MIN_CAPACITY = 16;
+	static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+	static constexpr uint32_t EMPTY = 0;
+	static constexpr float MAX_LOAD_FACTOR = 0.875f;
+
+	/*
+	*	32 bytes: the length followed by either the whole key (inline) or its first PREFIX_SIZE
+	*	bytes and its arena offset. Unused bytes are zero, so length and prefix of two keys can be
+	*	compared as one 8 byte word.
+	*/
+	struct StringKey
+	{
+		uint32_t length;
+		char bytes[INLINE_CAPACITY];
+
+		bool isInline() const
+		{
+			return length <= INLINE_CAPACITY;
+		}
+
+		uint64_t header() const
+		{
+			uint64_t word;
+			std::memcpy(&word, this, sizeof(word));
+			return word;
+		}
+
+		uint64_t arenaOffset() const
+		{
+			uint64_t offset;
+			std::memcpy(&offset, bytes + PREFIX_SIZE, sizeof(offset));
+			return offset;
+		}
+
+		void setArenaOffset(const uint64_t offset)
+		{
+			std::memcpy(bytes + PREFIX_SIZE, &offset, sizeof(offset));
+		}
+	};
+
+	static_assert(sizeof(StringKey) == 32, "StringKey must fill exactly half a cache line");
+
+	struct Slot
+	{
+		uint32_t dist;	  // probe distance + 1, EMPTY (0) if the slot holds no entry
+		uint32_t hashTag; // folded key hash, picks the home slot and rejects most mismatches
+		StringKey key;
+		typename std::aligned_storage<sizeof(V), alignof(V)>::type storage;
+
+		V& value()
+		{
+			return *std::launder(reinterpret_cast<V*>(&storage));
+		}
+
+		const V& value() const
+		{
+			return *std::launder(reinterpret_cast<const V*>(&storage));
+		}
+	};
+
+	static_assert(alignof(Slot) <= alignof(std::max_align_t), "over-aligned values are not supported");
+
+	static size_t roundUpToPowerOfTwo(const size_t value)
+	{
+		size_t result = MIN_CAPACITY;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	static Slot* allocateSlots(const size_t slotCount)
+	{
+		// calloc: every slot starts EMPTY without touching the pages up front
+		Slot* newSlots = static_cast<Slot*>(std::calloc(slotCount, sizeof(Slot)));
+		if (newSlots == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return newSlots;
+	}
+
+	static uint32_t tagOf(const std::string_view key)
+	{
+		const uint64_t hash = static_cast<uint64_t>(Hash{}(key));
+		return static_cast<uint32_t>(hash ^ (hash >> 32));
+	}
+
+	static size_t homeIndex(const uint32_t tag, const unsigned tableShift)
+	{
+		return FibonacciReducer::reduce(tag, tableShift);
+	}
+
+	// Header (length + zero padded prefix) of a key that is looked up
+	static uint64_t headerOf(const std::string_view key)
+	{
+		StringKey probe{};
+		probe.length = static_cast<uint32_t>(key.size());
+		if (!key.empty())
+		{
+			std::memcpy(probe.bytes, key.data(), key.size() < PREFIX_SIZE ? key.size() : PREFIX_SIZE);
+		}
+		return probe.header();
+	}
+
+	std::string_view keyOf(const StringKey& key) const
+	{
+		if (key.isInline())
+		{
+			return std::string_view(key.bytes, key.length);
+		}
+		return std::string_view(arena.data() + key.arenaOffset(), key.length);
+	}
+
+	StringKey makeKey(const std::string_view key)
+	{
+		StringKey stored{};
+		stored.length = static_cast<uint32_t>(key.size());
+		if (stored.isInline())
+		{
+			if (!key.empty())
+			{
+				std::memcpy(stored.bytes, key.data(), key.size());
+			}
+		}
+		else
+		{
+			std::memcpy(stored.bytes, key.data(), PREFIX_SIZE);
+			stored.setArenaOffset(arena.size());
+			arena.insert(arena.end(), key.begin(), key.end());
+		}
+		return stored;
+	}
+
+	size_t findIndex(const std::string_view key) const
+	{
+		return findIndex(key, tagOf(key));
+	}
+
+	size_t findIndex(const std::string_view key, const uint32_t tag) const
+	{
+		const size_t mask = capacity - 1;
+		const uint64_t header = headerOf(key);
+		size_t idx = homeIndex(tag, shift);
+		uint32_t dist = 1;
+
+		while (slots[idx].dist >= dist)
+		{
+			const Slot& slot = slots[idx];
+			if (slot.dist == dist && slot.hashTag == tag && slot.key.header() == header)
+			{
+				// length and prefix already match, so only the remaining bytes are compared
+				const char* stored = slot.key.isInline() ? slot.key.bytes : arena.data() + slot.key.arenaOffset();
+				if (key.size() <= PREFIX_SIZE || std::memcmp(stored + PREFIX_SIZE, key.data() + PREFIX_SIZE, key.size() - PREFIX_SIZE) == 0)
+				{
+					return idx;
+				}
+			}
+			idx = (idx + 1) & mask;
+			++dist;
+		}
+
+		return NOT_FOUND;
+	}
+
+	// Caller guarantees the key is not present and there is room for one more entry.
+	static void insertUnique(Slot* target, const size_t targetCapacity, const unsigned targetShift, uint32_t tag, StringKey key, V&& value)
+	{
+		const size_t mask = targetCapacity - 1;
+		size_t idx = homeIndex(tag, targetShift);
+		uint32_t dist = 1;
+
+		while (true)
+		{
+			Slot& slot = target[idx];
+			if (slot.dist == EMPTY)
+			{
+				slot.hashTag = tag;
+				slot.key = key;
+				new (&slot.storage) V(std::move(value));
+				slot.dist = dist;
+				return;
+			}
+
+			// steal the slot from a richer entry and carry that one further down the cluster
+			if (slot.dist < dist)
+			{
+				std::swap(slot.hashTag, tag);
+				std::swap(slot.key, key);
+				std::swap(slot.value(), value);
+				std::swap(slot.dist, dist);
+			}
+
+			idx = (idx + 1) & mask;
+			++dist;
+		}
+	}
+
+	void growIfNeeded()
+	{
+		if (static_cast<float>(count + 1) > static_cast<float>(capacity) * MAX_LOAD_FACTOR)
+		{
+			rehash(capacity * 2);
+		}
+		else if (arenaGarbage > arena.size() / 2 && arenaGarbage >= capacity)
+		{
+			// a table that churns without growing still has to drop erased keys now and then,
+			// the garbage is at least the slot count so the rebuild stays amortized
+			rehash(capacity);
+		}
+	}
+
+	/*
+	*	Moves every entry into a new slot array of newCapacity slots. Keys are not hashed again,
+	*	their tag is enough. If more than half of the arena belongs to erased keys, the live long
+	*	keys are copied into a fresh arena on the way.
+	*/
+	void rehash(const size_t newCapacity)
+	{
+		Slot* newSlots = allocateSlots(newCapacity);
+		const unsigned newShift = FibonacciReducer::shiftFor(newCapacity);
+
+		const bool compact = arenaGarbage > arena.size() / 2;
+		std::vector<char> newArena;
+		if (compact)
+		{
+			newArena.reserve(arena.size() - arenaGarbage);
+		}
+
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			Slot& slot = slots[i];
+			if (slot.dist != EMPTY)
+			{
+				StringKey key = slot.key;
+				if (compact && !key.isInline())
+				{
+					const char* bytes = arena.data() + key.arenaOffset();
+					key.setArenaOffset(newArena.size());
+					newArena.insert(newArena.end(), bytes, bytes + key.length);
+				}
+				insertUnique(newSlots, newCapacity, newShift, slot.hashTag, key, std::move(slot.value()));
+				slot.value().~V();
+			}
+		}
+
+		std::free(slots);
+		slots = newSlots;
+		capacity = newCapacity;
+		shift = newShift;
+		if (compact)
+		{
+			arena.swap(newArena);
+			arenaGarbage = 0;
+		}
+	}
+
+	void destroyValues()
+	{
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (slots[i].dist != EMPTY)
+			{
+				slots[i].value().~V();
+				slots[i].dist = EMPTY;
+			}
+		}
+		count = 0;
+	}
+
+private:
+	size_t capacity;
+	unsigned shift;
+	size_t count;
+	Slot* slots;
+	std::vector<char> arena; // long keys back to back, addressed by offset so the vector may grow
+	size_t arenaGarbage;	 // bytes of erased long keys
+};
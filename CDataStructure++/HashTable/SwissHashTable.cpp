@@ -0,0 +1 @@
+#include <SwissHashTable.h>
\ No newline at end of file
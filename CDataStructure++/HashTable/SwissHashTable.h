@@ -0,0 +1,611 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CDS_HASH_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "HashPolicies.h"
+
+/*
+*	Swiss-table style open-addressing hash table.
+*	Next to the slot array it keeps one control byte per slot: either EMPTY, DELETED or the
+*	lowest 7 bits of the key hash (the tag). Probing walks over aligned groups of 16 control
+*	bytes and compares all 16 tags at once (SSE2, scalar fallback otherwise), so a full key
+*	comparison is only done for slots whose tag already matches. That keeps lookups cheap
+*	up to the default 7/8 load factor (see max_load_factor()).
+*	Like FlatHashTable, a transparent Hash and KeyEqual enable lookups with any key type
+*	comparable to K.
+*/
+template<typename K, typename V, typename Hash = FastHash<K>, typename KeyEqual = std::equal_to<>>
+class SwissHashTable
+{
+public:
+	using Entry = std::pair<K, V>;
+
+private:
+	// K itself, or any key type if the lookup is transparent
+	template<typename Key>
+	using EnableLookup = typename std::enable_if<std::is_same<Key, K>::value || IsTransparentLookup<Hash, KeyEqual>::value>::type;
+
+public:
+	SwissHashTable(const size_t capacity = GROUP_WIDTH)
+		:
+		groupCount(groupsFor(capacity)),
+		count(0),
+		growthLeft(0),
+		maxLoadFactor(DEFAULT_MAX_LOAD_FACTOR),
+		ctrl(nullptr),
+		entries(nullptr)
+	{
+		allocate(groupCount);
+	}
+
+	// Delete constructors which may cause headache and bugs
+	SwissHashTable(const SwissHashTable&) = delete;
+	SwissHashTable(SwissHashTable&&) = delete;
+
+	~SwissHashTable()
+	{
+		destroyEntries();
+		delete[] ctrl;
+		delete[] entries;
+	}
+
+	V* find(const K& key)
+	{
+		return find<K>(key);
+	}
+
+	const V* find(const K& key) const
+	{
+		return find<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	V* find(const Key& key)
+	{
+		const auto idx = findIndex(key);
+		return idx == NOT_FOUND ? nullptr : &entryAt(idx).second;
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	const V* find(const Key& key) const
+	{
+		const auto idx = findIndex(key);
+		return idx == NOT_FOUND ? nullptr : &entryAt(idx).second;
+	}
+
+	bool contains(const K& key) const
+	{
+		return findIndex(key) != NOT_FOUND;
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool contains(const Key& key) const
+	{
+		return findIndex(key) != NOT_FOUND;
+	}
+
+	/*
+	*	Inserts the pair if the key is not present yet. Returns false when the key already exists.
+	*/
+	bool insert(const K& key, const V& value)
+	{
+		if (findIndex(key) != NOT_FOUND)
+		{
+			return false;
+		}
+
+		insertUnique(Entry(key, value));
+		return true;
+	}
+
+	/*
+	*	Inserts the pair or overwrites the value of an existing key.
+	*	Returns true if a new key was inserted, false if an existing value was assigned.
+	*/
+	bool insert_or_assign(const K& key, const V& value)
+	{
+		const auto idx = findIndex(key);
+		if (idx != NOT_FOUND)
+		{
+			entryAt(idx).second = value;
+			return false;
+		}
+
+		insertUnique(Entry(key, value));
+		return true;
+	}
+
+	bool erase(const K& key)
+	{
+		return erase<K>(key);
+	}
+
+	template<typename Key, typename = EnableLookup<Key>>
+	bool erase(const Key& key)
+	{
+		const auto idx = findIndex(key);
+		if (idx == NOT_FOUND)
+		{
+			return false;
+		}
+
+		entryAt(idx).~Entry();
+		--count;
+
+		// A probe only continues past a group without EMPTY bytes, so if this group still has
+		// one nobody can have probed through it and the slot can become EMPTY again.
+		Group& group = ctrl[idx / GROUP_WIDTH];
+		if (group.matchEmpty() != 0)
+		{
+			group.setByte(idx % GROUP_WIDTH, EMPTY);
+			++growthLeft;
+		}
+		else
+		{
+			group.setByte(idx % GROUP_WIDTH, DELETED);
+		}
+		return true;
+	}
+
+	/*
+	*	Removes every entry for which pred(key, value) returns true in one sweep over the groups
+	*	and returns how many were removed. The freed slots follow the rule of erase, decided per
+	*	group: they become EMPTY again if their group had an EMPTY byte before the sweep, DELETED
+	*	otherwise. A sweep that leaves many DELETED markers behind rebuilds the table in place.
+	*/
+	template<typename Pred>
+	size_t erase_if(Pred pred)
+	{
+		size_t removed = 0;
+		size_t tombstones = 0;
+		for (size_t g = 0; g < groupCount; ++g)
+		{
+			Group& group = ctrl[g];
+			const uint8_t freed = group.matchEmpty() != 0 ? EMPTY : DELETED;
+			uint32_t full = ~group.matchEmptyOrDeleted() & ((1u << GROUP_WIDTH) - 1);
+			while (full != 0)
+			{
+				const size_t slotIdx = lowestBitIndex(full);
+				full &= full - 1;
+
+				Entry& entry = entryAt(g * GROUP_WIDTH + slotIdx);
+				if (pred(entry.first, entry.second))
+				{
+					entry.~Entry();
+					group.setByte(slotIdx, freed);
+					++removed;
+					if (freed == EMPTY)
+					{
+						++growthLeft;
+					}
+					else
+					{
+						++tombstones;
+					}
+				}
+			}
+		}
+		count -= removed;
+
+		// DELETED markers make every probe through them longer, a bulk expiry is a good moment to drop them
+		if (tombstones > getCapacity() / 8)
+		{
+			rehash(getCapacity());
+		}
+		return removed;
+	}
+
+	/*
+	*	Keeps only the entries for which pred(key, value) returns true, in the same single sweep
+	*	as erase_if. pred may update the values it keeps. Returns the number of removed entries.
+	*/
+	template<typename Pred>
+	size_t retain(Pred pred)
+	{
+		return erase_if([&pred](const K& key, V& value)
+			{
+				return !pred(key, value);
+			});
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return groupCount * GROUP_WIDTH;
+	}
+
+	float load_factor() const
+	{
+		return static_cast<float>(count) / static_cast<float>(getCapacity());
+	}
+
+	float max_load_factor() const
+	{
+		return maxLoadFactor;
+	}
+
+	/*
+	*	Sets the load factor at which the table grows, clamped to [MIN_MAX_LOAD_FACTOR, MAX_MAX_LOAD_FACTOR].
+	*	Takes effect immediately: the table is rebuilt at its current (or a larger) capacity.
+	*/
+	void max_load_factor(const float newMaxLoadFactor)
+	{
+		maxLoadFactor = newMaxLoadFactor < MIN_MAX_LOAD_FACTOR ? MIN_MAX_LOAD_FACTOR
+			: newMaxLoadFactor > MAX_MAX_LOAD_FACTOR ? MAX_MAX_LOAD_FACTOR
+			: newMaxLoadFactor;
+		rehash(getCapacity());
+	}
+
+	/*
+	*	Makes room for at least entryCount entries without growing again.
+	*/
+	void reserve(const size_t entryCount)
+	{
+		rehash(static_cast<size_t>(static_cast<float>(entryCount) / maxLoadFactor) + 1);
+	}
+
+	/*
+	*	Rebuilds the table with at least slotCount slots (rounded up to whole groups, power of two
+	*	group count, never below what the current entries need). Also drops all DELETED markers.
+	*/
+	void rehash(const size_t slotCount)
+	{
+		const size_t needed = static_cast<size_t>(static_cast<float>(count) / maxLoadFactor) + 1;
+		rehashToGroups(groupsFor(slotCount > needed ? slotCount : needed));
+	}
+
+	template<typename Func>
+	void forEach(Func func) const
+	{
+		const size_t capacity = getCapacity();
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (isFull(ctrlByte(i)))
+			{
+				func(entryAt(i).first, entryAt(i).second);
+			}
+		}
+	}
+
+	void printBinsInfo() const
+	{
+		for (size_t g = 0; g < groupCount; ++g)
+		{
+			size_t full = 0;
+			for (size_t i = 0; i < GROUP_WIDTH; ++i)
+			{
+				full += isFull(ctrlByte(g * GROUP_WIDTH + i)) ? 1 : 0;
+			}
+			std::cout << "Group: " << g << "\t" << "Values: " << full << "/" << GROUP_WIDTH << std::endl;
+		}
+		getDistributionStats().print("probe length (groups)");
+	}
+
+	/*
+	*	Probe length statistics over all entries, counted in groups visited after the home group.
+	*	Empty buckets are slots that are EMPTY or DELETED.
+	*/
+	HashDistributionStats getDistributionStats() const
+	{
+		HashDistributionStats stats;
+		stats.buckets = getCapacity();
+		stats.entries = count;
+		stats.emptyBuckets = getCapacity() - count;
+		if (count == 0)
+		{
+			return stats;
+		}
+
+		const size_t groupMask = groupCount - 1;
+		double sum = 0;
+		double sumOfSquares = 0;
+		for (size_t idx = 0; idx < getCapacity(); ++idx)
+		{
+			if (isFull(ctrlByte(idx)))
+			{
+				size_t probeLength = 0;
+				for (size_t g = firstGroupOf(mixedHash(entryAt(idx).first)); g != idx / GROUP_WIDTH; g = (g + probeLength) & groupMask)
+				{
+					++probeLength;
+				}
+				stats.maxLength = probeLength > stats.maxLength ? probeLength : stats.maxLength;
+				sum += static_cast<double>(probeLength);
+				sumOfSquares += static_cast<double>(probeLength) * static_cast<double>(probeLength);
+			}
+		}
+		stats.meanLength = sum / static_cast<double>(count);
+		stats.variance = sumOfSquares / static_cast<double>(count) - stats.meanLength * stats.meanLength;
+		return stats;
+	}
+
+private:
+	static constexpr size_t GROUP_WIDTH = 16;
+	static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+	static constexpr uint8_t EMPTY = 0x80;   // 0b10000000
+	static constexpr uint8_t DELETED = 0xFE; // 0b11111110
+	// Full slots store a 7 bit tag so the top bit is only set for EMPTY and DELETED
+	static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.875f;
+	static constexpr float MIN_MAX_LOAD_FACTOR = 0.25f;
+	static constexpr float MAX_MAX_LOAD_FACTOR = 0.9375f;
+
+	using EntryStorage = typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type;
+
+	/*
+	*	16 control bytes that are probed together. Every match* function returns a bitmask where
+	*	bit i is set if byte i matches.
+	*/
+	struct alignas(GROUP_WIDTH) Group
+	{
+		uint8_t bytes[GROUP_WIDTH];
+
+		uint32_t match(const uint8_t tag) const
+		{
+#ifdef CDS_HASH_TABLE_SSE2
+			const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < GROUP_WIDTH; ++i)
+			{
+				mask |= static_cast<uint32_t>(bytes[i] == tag) << i;
+			}
+			return mask;
+#endif
+		}
+
+		uint32_t matchEmpty() const
+		{
+			return match(EMPTY);
+		}
+
+		// EMPTY and DELETED are the only control bytes with the top bit set
+		uint32_t matchEmptyOrDeleted() const
+		{
+#ifdef CDS_HASH_TABLE_SSE2
+			const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+			return static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < GROUP_WIDTH; ++i)
+			{
+				mask |= static_cast<uint32_t>(bytes[i] >> 7) << i;
+			}
+			return mask;
+#endif
+		}
+
+		void setByte(const size_t idx, const uint8_t value)
+		{
+			bytes[idx] = value;
+		}
+	};
+
+	static unsigned lowestBitIndex(const uint32_t mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanForward(&idx, mask);
+		return static_cast<unsigned>(idx);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	static bool isFull(const uint8_t ctrlValue)
+	{
+		return (ctrlValue & 0x80) == 0;
+	}
+
+	static size_t groupsFor(const size_t capacity)
+	{
+		size_t groups = 1;
+		while (groups * GROUP_WIDTH < capacity)
+		{
+			groups <<= 1;
+		}
+		return groups;
+	}
+
+	// A custom Hash may be weak in some bits (std::hash is the identity for integers), so spread
+	// the bits before splitting the hash into a group index (upper part) and a 7 bit tag (lower part).
+	template<typename Key>
+	static uint64_t mixedHash(const Key& key)
+	{
+		uint64_t h = static_cast<uint64_t>(Hash{}(key)) * 11400714819323198485ull;
+		return h ^ (h >> 32);
+	}
+
+	static uint8_t tagOf(const uint64_t hash)
+	{
+		return static_cast<uint8_t>(hash & 0x7F);
+	}
+
+	size_t firstGroupOf(const uint64_t hash) const
+	{
+		return static_cast<size_t>(hash >> 7) & (groupCount - 1);
+	}
+
+	uint8_t ctrlByte(const size_t idx) const
+	{
+		return ctrl[idx / GROUP_WIDTH].bytes[idx % GROUP_WIDTH];
+	}
+
+	Entry& entryAt(const size_t idx)
+	{
+		return *std::launder(reinterpret_cast<Entry*>(&entries[idx]));
+	}
+
+	const Entry& entryAt(const size_t idx) const
+	{
+		return *std::launder(reinterpret_cast<const Entry*>(&entries[idx]));
+	}
+
+	template<typename Key>
+	size_t findIndex(const Key& key) const
+	{
+		const uint64_t hash = mixedHash(key);
+		const uint8_t tag = tagOf(hash);
+		const size_t groupMask = groupCount - 1;
+		size_t g = firstGroupOf(hash);
+
+		// triangular probing over the groups visits every group once for power of two group counts
+		for (size_t step = 1; step <= groupCount; ++step)
+		{
+			const Group& group = ctrl[g];
+			uint32_t candidates = group.match(tag);
+			while (candidates != 0)
+			{
+				const size_t idx = g * GROUP_WIDTH + lowestBitIndex(candidates);
+				if (KeyEqual{}(entryAt(idx).first, key))
+				{
+					return idx;
+				}
+				candidates &= candidates - 1;
+			}
+
+			if (group.matchEmpty() != 0)
+			{
+				return NOT_FOUND;
+			}
+			g = (g + step) & groupMask;
+		}
+
+		return NOT_FOUND;
+	}
+
+	size_t findInsertSlot(const uint64_t hash) const
+	{
+		const size_t groupMask = groupCount - 1;
+		size_t g = firstGroupOf(hash);
+
+		for (size_t step = 1; ; ++step)
+		{
+			const uint32_t available = ctrl[g].matchEmptyOrDeleted();
+			if (available != 0)
+			{
+				return g * GROUP_WIDTH + lowestBitIndex(available);
+			}
+			g = (g + step) & groupMask;
+		}
+	}
+
+	// Caller guarantees the key is not present.
+	void insertUnique(Entry&& entry)
+	{
+		const uint64_t hash = mixedHash(entry.first);
+		size_t idx = findInsertSlot(hash);
+
+		// Reusing a DELETED slot does not consume growth, an EMPTY one does
+		if (growthLeft == 0 && ctrlByte(idx) == EMPTY)
+		{
+			rehash(static_cast<size_t>(static_cast<float>(count + 1) / maxLoadFactor) + 1);
+			idx = findInsertSlot(hash);
+		}
+
+		if (ctrlByte(idx) == EMPTY)
+		{
+			--growthLeft;
+		}
+		new (&entries[idx]) Entry(std::move(entry));
+		ctrl[idx / GROUP_WIDTH].setByte(idx % GROUP_WIDTH, tagOf(hash));
+		++count;
+	}
+
+	void allocate(const size_t groups)
+	{
+		// allocate both arrays before touching any member, so a throwing new leaves the table as it was
+		Group* newCtrl = new Group[groups];
+		EntryStorage* newEntries = nullptr;
+		try
+		{
+			newEntries = new EntryStorage[groups * GROUP_WIDTH];
+		}
+		catch (...)
+		{
+			delete[] newCtrl;
+			throw;
+		}
+		std::memset(newCtrl, EMPTY, groups * sizeof(Group));
+
+		groupCount = groups;
+		ctrl = newCtrl;
+		entries = newEntries;
+		// keep at least one slot free so an insert probe always terminates
+		const size_t maxEntries = static_cast<size_t>(static_cast<float>(groups * GROUP_WIDTH) * maxLoadFactor);
+		growthLeft = maxEntries < groups * GROUP_WIDTH ? maxEntries : groups * GROUP_WIDTH - 1;
+	}
+
+	void rehashToGroups(const size_t groups)
+	{
+		Group* oldCtrl = ctrl;
+		EntryStorage* oldEntries = entries;
+		const size_t oldCapacity = getCapacity();
+
+		allocate(groups);
+		count = 0;
+
+		for (size_t i = 0; i < oldCapacity; ++i)
+		{
+			if (isFull(oldCtrl[i / GROUP_WIDTH].bytes[i % GROUP_WIDTH]))
+			{
+				Entry* oldEntry = std::launder(reinterpret_cast<Entry*>(&oldEntries[i]));
+				const uint64_t hash = mixedHash(oldEntry->first);
+				const size_t idx = findInsertSlot(hash);
+
+				new (&entries[idx]) Entry(std::move(*oldEntry));
+				ctrl[idx / GROUP_WIDTH].setByte(idx % GROUP_WIDTH, tagOf(hash));
+				oldEntry->~Entry();
+				--growthLeft;
+				++count;
+			}
+		}
+
+		delete[] oldCtrl;
+		delete[] oldEntries;
+	}
+
+	void destroyEntries()
+	{
+		const size_t capacity = getCapacity();
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (isFull(ctrlByte(i)))
+			{
+				entryAt(i).~Entry();
+			}
+		}
+	}
+
+private:
+	size_t groupCount;
+	size_t count;
+	size_t growthLeft;
+	float maxLoadFactor;
+	Group* ctrl;
+	EntryStorage* entries;
+};
@@ -0,0 +1 @@
+#include <AtomicNode.h>
\ No newline at end of file
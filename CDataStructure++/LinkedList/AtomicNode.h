@@ -0,0 +1,63 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstdint>
+
+/*
+*	Node<T> counterpart for the lock-free containers: the next pointer is atomic.
+*	Lists that delete logically before unlinking (Harris/Michael) keep a "marked" flag in the
+*	lowest bit of next, which is always free because nodes are at least pointer aligned.
+*/
+template<typename T>
+class AtomicNode
+{
+public:
+	AtomicNode()
+		:
+		data(),
+		next(nullptr)
+	{
+	}
+
+	AtomicNode(const T& data)
+		:
+		data(data),
+		next(nullptr)
+	{
+	}
+
+	AtomicNode(const T& data, AtomicNode<T>* next)
+		:
+		data(data),
+		next(next)
+	{
+	}
+
+	static bool isMarked(const AtomicNode* ptr)
+	{
+		return (reinterpret_cast<uintptr_t>(ptr) & MARK_BIT) != 0;
+	}
+
+	static AtomicNode* marked(const AtomicNode* ptr)
+	{
+		return reinterpret_cast<AtomicNode*>(reinterpret_cast<uintptr_t>(ptr) | MARK_BIT);
+	}
+
+	static AtomicNode* unmarked(const AtomicNode* ptr)
+	{
+		return reinterpret_cast<AtomicNode*>(reinterpret_cast<uintptr_t>(ptr) & ~MARK_BIT);
+	}
+
+	friend std::ostream& operator<<(std::ostream& stream, const AtomicNode& node)
+	{
+		stream << "Node Addr: " << &node << ", Node Data: " << node.data << ", Node Next Addr: " << node.next.load();
+		return stream;
+	}
+
+	T data;
+	std::atomic<AtomicNode*> next;
+
+private:
+	static constexpr uintptr_t MARK_BIT = 1;
+};
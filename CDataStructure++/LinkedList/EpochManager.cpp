@@ -0,0 +1 @@
+#include <EpochManager.h>
\ No newline at end of file
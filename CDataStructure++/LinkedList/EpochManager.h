@@ -0,0 +1,245 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+*	Epoch based memory reclamation for the lock-free containers.
+*
+*	A thread pins itself (EpochManager::Guard) before it touches shared nodes and unpins when it
+*	no longer holds any pointer to them. Unlinked nodes are not deleted right away but retired
+*	together with the global epoch at that moment. The global epoch only moves forward once every
+*	pinned thread has seen the current epoch, so a node retired in epoch e can be freed as soon as
+*	the global epoch reaches e + 2: no thread can still be reading it.
+*
+*	Pinning is a single atomic exchange, it never blocks or waits for other threads, so readers stay
+*	wait-free. Because a node can't be freed (and its address reused) while anybody who might have
+*	loaded it is still pinned, this also rules out the ABA problem for compare-and-swap loops.
+*/
+class EpochManager
+{
+public:
+	/*
+	*	RAII pin of the calling thread. Guards may be nested.
+	*/
+	class Guard
+	{
+	public:
+		explicit Guard(EpochManager& manager)
+			:
+			manager(manager)
+		{
+			manager.pin();
+		}
+
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+
+		~Guard()
+		{
+			manager.unpin();
+		}
+
+	private:
+		EpochManager& manager;
+	};
+
+public:
+	static EpochManager& instance()
+	{
+		static EpochManager manager;
+		return manager;
+	}
+
+	EpochManager(const EpochManager&) = delete;
+	EpochManager(EpochManager&&) = delete;
+
+	~EpochManager()
+	{
+		// Only reached at program exit, nobody is pinned anymore
+		ThreadRecord* record = records.load();
+		while (record != nullptr)
+		{
+			ThreadRecord* nextRecord = record->next;
+			for (auto& retired : record->limbo)
+			{
+				retired.deleter(retired.ptr);
+			}
+			delete record;
+			record = nextRecord;
+		}
+	}
+
+	Guard guard()
+	{
+		return Guard(*this);
+	}
+
+	/*
+	*	Hands ownership of an unlinked node to the manager, it is deleted once no pinned thread can
+	*	reference it anymore. Must be called while pinned.
+	*/
+	template<typename T>
+	void retire(T* ptr)
+	{
+		retire(ptr, [](void* toDelete) { delete static_cast<T*>(toDelete); });
+	}
+
+	void retire(void* ptr, void (*deleter)(void*))
+	{
+		ThreadRecord& record = localRecord();
+		record.limbo.push_back(Retired{ ptr, deleter, globalEpoch.load(std::memory_order_relaxed) });
+
+		if (record.limbo.size() % COLLECT_THRESHOLD == 0)
+		{
+			tryAdvance();
+			collect(record);
+		}
+	}
+
+private:
+	static constexpr size_t COLLECT_THRESHOLD = 64;
+	static constexpr uint64_t ACTIVE = 1;
+
+	struct Retired
+	{
+		void* ptr;
+		void (*deleter)(void*);
+		uint64_t epoch;
+	};
+
+	// One record per thread, padded so pinning doesn't bounce cache lines between threads
+	struct alignas(64) ThreadRecord
+	{
+		ThreadRecord()
+			:
+			state(0),
+			inUse(true),
+			next(nullptr),
+			nesting(0),
+			collectedEpoch(0)
+		{
+		}
+
+		std::atomic<uint64_t> state; // (observed epoch << 1) | ACTIVE while pinned, 0 otherwise
+		std::atomic<bool> inUse;	 // owned by a live thread
+		ThreadRecord* next;
+		size_t nesting;
+		uint64_t collectedEpoch;	 // global epoch at the last collect
+		std::vector<Retired> limbo; // in retire order, so the epochs never decrease
+	};
+
+	// Gives the record back when the owning thread exits, its limbo is adopted by the next owner
+	struct LocalRecord
+	{
+		~LocalRecord()
+		{
+			if (record != nullptr)
+			{
+				record->inUse.store(false, std::memory_order_release);
+			}
+		}
+
+		ThreadRecord* record = nullptr;
+	};
+
+	EpochManager()
+		:
+		globalEpoch(0),
+		records(nullptr)
+	{
+	}
+
+	ThreadRecord& localRecord()
+	{
+		thread_local LocalRecord local;
+		if (local.record == nullptr)
+		{
+			local.record = acquireRecord();
+		}
+		return *local.record;
+	}
+
+	ThreadRecord* acquireRecord()
+	{
+		for (ThreadRecord* record = records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+		{
+			bool expected = false;
+			if (!record->inUse.load(std::memory_order_relaxed) && record->inUse.compare_exchange_strong(expected, true))
+			{
+				return record;
+			}
+		}
+
+		ThreadRecord* record = new ThreadRecord();
+		ThreadRecord* head = records.load(std::memory_order_relaxed);
+		do
+		{
+			record->next = head;
+		} while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+		return record;
+	}
+
+	void pin()
+	{
+		ThreadRecord& record = localRecord();
+		if (record.nesting++ == 0)
+		{
+			// a seq_cst read-modify-write is a full barrier: the announcement is visible before any
+			// shared node is loaded
+			record.state.exchange((globalEpoch.load(std::memory_order_relaxed) << 1) | ACTIVE, std::memory_order_seq_cst);
+		}
+	}
+
+	void unpin()
+	{
+		ThreadRecord& record = localRecord();
+		if (--record.nesting == 0)
+		{
+			record.state.store(0, std::memory_order_release);
+		}
+	}
+
+	// The epoch may only advance when every pinned thread has observed the current one
+	void tryAdvance()
+	{
+		uint64_t epoch = globalEpoch.load(std::memory_order_seq_cst);
+		for (ThreadRecord* record = records.load(std::memory_order_acquire); record != nullptr; record = record->next)
+		{
+			const uint64_t state = record->state.load(std::memory_order_seq_cst);
+			if ((state & ACTIVE) != 0 && (state >> 1) != epoch)
+			{
+				return;
+			}
+		}
+		globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+	}
+
+	/*
+	*	Frees the expired front of the limbo. While a pinned thread holds the epoch back nothing can
+	*	expire, so the pass is skipped until the epoch moves instead of rescanning a growing limbo.
+	*/
+	void collect(ThreadRecord& record)
+	{
+		const uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+		if (epoch == record.collectedEpoch)
+		{
+			return;
+		}
+		record.collectedEpoch = epoch;
+
+		size_t expired = 0;
+		while (expired < record.limbo.size() && record.limbo[expired].epoch + 2 <= epoch)
+		{
+			record.limbo[expired].deleter(record.limbo[expired].ptr);
+			++expired;
+		}
+		record.limbo.erase(record.limbo.begin(), record.limbo.begin() + expired);
+	}
+
+private:
+	std::atomic<uint64_t> globalEpoch;
+	std::atomic<ThreadRecord*> records;
+};
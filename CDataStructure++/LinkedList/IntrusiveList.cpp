@@ -0,0 +1 @@
+#include <IntrusiveList.h>
\ No newline at end of file
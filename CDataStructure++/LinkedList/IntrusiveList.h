@@ -0,0 +1,196 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+
+/*
+*	Link fields of an element that can be put in an IntrusiveList. Elements derive from it, once
+*	per list they can be in at the same time (use a different Tag for each).
+*/
+template<typename Tag = void>
+class IntrusiveListHook
+{
+public:
+	IntrusiveListHook()
+		:
+		prev(nullptr),
+		next(nullptr)
+	{
+	}
+
+	// A hook belongs to one list position, copying an element must not copy its links
+	IntrusiveListHook(const IntrusiveListHook&)
+		:
+		prev(nullptr),
+		next(nullptr)
+	{
+	}
+
+	IntrusiveListHook& operator=(const IntrusiveListHook&)
+	{
+		return *this;
+	}
+
+	bool isLinked() const
+	{
+		return next != nullptr;
+	}
+
+private:
+	template<typename T, typename ListTag>
+	friend class IntrusiveList;
+
+	IntrusiveListHook* prev;
+	IntrusiveListHook* next;
+};
+
+/*
+*	Doubly linked list whose links live inside the elements (see IntrusiveListHook), so linking,
+*	unlinking and moving an element are O(1) pointer updates without any allocation.
+*	The list never owns its elements: destroying or clearing it only unlinks them.
+*	It is circular around a sentinel hook, so no operation needs a nullptr special case.
+*/
+template<typename T, typename Tag = void>
+class IntrusiveList
+{
+public:
+	using Hook = IntrusiveListHook<Tag>;
+
+public:
+	IntrusiveList()
+		:
+		size(0)
+	{
+		sentinel.prev = &sentinel;
+		sentinel.next = &sentinel;
+	}
+
+	// Delete constructors which may cause headache and bugs
+	IntrusiveList(const IntrusiveList&) = delete;
+	IntrusiveList(IntrusiveList&&) = delete;
+
+	~IntrusiveList()
+	{
+		clear();
+	}
+
+	void pushFront(T& element)
+	{
+		linkAfter(&sentinel, hookOf(element));
+	}
+
+	void pushBack(T& element)
+	{
+		linkAfter(sentinel.prev, hookOf(element));
+	}
+
+	// Links element right before position, which has to be in this list
+	void insertBefore(T& position, T& element)
+	{
+		linkAfter(hookOf(position)->prev, hookOf(element));
+	}
+
+	void remove(T& element)
+	{
+		Hook* hook = hookOf(element);
+		hook->prev->next = hook->next;
+		hook->next->prev = hook->prev;
+		hook->prev = nullptr;
+		hook->next = nullptr;
+		--size;
+	}
+
+	void moveToFront(T& element)
+	{
+		remove(element);
+		pushFront(element);
+	}
+
+	T* popFront()
+	{
+		T* element = front();
+		if (element != nullptr)
+		{
+			remove(*element);
+		}
+		return element;
+	}
+
+	T* popBack()
+	{
+		T* element = back();
+		if (element != nullptr)
+		{
+			remove(*element);
+		}
+		return element;
+	}
+
+	T* front() const
+	{
+		return elementOf(sentinel.next);
+	}
+
+	T* back() const
+	{
+		return elementOf(sentinel.prev);
+	}
+
+	// Element after element, nullptr at the end of the list
+	T* next(const T& element) const
+	{
+		return elementOf(hookOf(element)->next);
+	}
+
+	// Element before element, nullptr at the start of the list
+	T* prev(const T& element) const
+	{
+		return elementOf(hookOf(element)->prev);
+	}
+
+	void clear()
+	{
+		while (popFront() != nullptr)
+		{
+		}
+	}
+
+	bool empty() const
+	{
+		return size == 0;
+	}
+
+	size_t getSize() const
+	{
+		return size;
+	}
+
+private:
+	static Hook* hookOf(T& element)
+	{
+		return static_cast<Hook*>(&element);
+	}
+
+	static const Hook* hookOf(const T& element)
+	{
+		return static_cast<const Hook*>(&element);
+	}
+
+	T* elementOf(Hook* hook) const
+	{
+		return hook == &sentinel ? nullptr : static_cast<T*>(hook);
+	}
+
+	void linkAfter(Hook* position, Hook* hook)
+	{
+		hook->prev = position;
+		hook->next = position->next;
+		position->next->prev = hook;
+		position->next = hook;
+		++size;
+	}
+
+private:
+	mutable Hook sentinel;
+	size_t size;
+};
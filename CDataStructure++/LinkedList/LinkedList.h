@@ -1,34 +1,152 @@
 #pragma once
 
 #include <iostream>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "Node.h"
+#include "../Allocator/PoolAllocator.h"
 
-template<typename V>
+/*
+*	Singly linked list. Nodes are allocated with Allocator (rebound to Node<V>); pass a
+*	PoolAllocator to take them from a slab pool instead of one new/delete per node.
+*	A tail pointer makes insertAtTail, popFront and splice O(1), so the list also works as a
+*	FIFO queue.
+*	Forward iterators (begin/end) make it usable with range-for and <algorithm>; find and
+*	getNode return iterators/pointers into the list and never allocate.
+*	sort and parallelSort reorder the list by relinking its nodes, values are never copied.
+*/
+template<typename V, typename Allocator = std::allocator<V>>
 class LinkedList
 {
+private:
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node<V>>;
+	using NodeAllocatorTraits = std::allocator_traits<NodeAllocator>;
+
+	/*
+	*	Forward iterator over the values. Stays valid until its node is deleted; insertions and
+	*	splices don't invalidate it.
+	*/
+	template<bool IsConst>
+	class BasicIterator
+	{
+	private:
+		using NodePointer = typename std::conditional<IsConst, const Node<V>*, Node<V>*>::type;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = V;
+		using difference_type = std::ptrdiff_t;
+		using pointer = typename std::conditional<IsConst, const V*, V*>::type;
+		using reference = typename std::conditional<IsConst, const V&, V&>::type;
+
+	public:
+		BasicIterator()
+			:
+			node(nullptr)
+		{
+		}
+
+		explicit BasicIterator(NodePointer node)
+			:
+			node(node)
+		{
+		}
+
+		// iterator converts to const_iterator
+		template<bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+		BasicIterator(const BasicIterator<WasConst>& other)
+			:
+			node(other.getNode())
+		{
+		}
+
+		reference operator*() const
+		{
+			return node->data;
+		}
+
+		pointer operator->() const
+		{
+			return &node->data;
+		}
+
+		BasicIterator& operator++()
+		{
+			node = node->next;
+			return *this;
+		}
+
+		BasicIterator operator++(int)
+		{
+			BasicIterator previous = *this;
+			node = node->next;
+			return previous;
+		}
+
+		// the node the iterator points to, nullptr for end()
+		NodePointer getNode() const
+		{
+			return node;
+		}
+
+		friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs)
+		{
+			return lhs.node == rhs.node;
+		}
+
+		friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs)
+		{
+			return lhs.node != rhs.node;
+		}
+
+	private:
+		NodePointer node;
+	};
+
 public:
-	LinkedList()
+	using iterator = BasicIterator<false>;
+	using const_iterator = BasicIterator<true>;
+
+public:
+	explicit LinkedList(const Allocator& allocator = Allocator())
 		:
+		nodeAllocator(allocator),
 		headNode(nullptr),
+		tailNode(nullptr),
 		size(0)
 	{
 	}
 
-	LinkedList(const V& data)
+	LinkedList(const V& data, const Allocator& allocator = Allocator())
 		:
-		headNode(new Node<V>(data)),
+		nodeAllocator(allocator),
+		headNode(createNode(data)),
+		tailNode(headNode),
 		size(1)
 	{
 	}
 
 	~LinkedList()
 	{
+		// with a pool of its own the slabs are freed wholesale, no need to visit every node
+		if (poolFreesInBulk<Node<V>>(nodeAllocator))
+		{
+			return;
+		}
+
 		Node<V>* tempNext = headNode;
 		while (tempNext != nullptr)
 		{
 			auto temp = tempNext->next;
-			delete tempNext;
+			destroyNode(tempNext);
 			tempNext = temp;
 		}
 	}
@@ -72,34 +190,73 @@ public:
 		std::cout << "\n\n";
 	}
 
-	//void insertNode(Node<V>* const node)
-	//{
-	//	if (this->headNode == nullptr)
-	//	{
-	//		this->headNode = node; // The head node mem. address points to the inserted node if head node is null.
-	//	}
-	//	else
-	//	{
-	//		this->lastNode->next = node; // modify the previous node to point to the next (now last) node.
-	//		this->lastNode = node; // save ref to added node.
-	//	}
-
-	//	size++; // increment the size of the linked list.
-	//}
-
 	void insertAtHead(const V& data)
 	{
-		Node<V>* nextNode = new Node<V>(data); // create node out of the given data.
+		Node<V>* nextNode = createNode(data); // create node out of the given data.
 
 		if (this->headNode != nullptr)
 		{
 			nextNode->next = this->headNode; // assign next node to head node ref
 		}
+		else
+		{
+			this->tailNode = nextNode; // the only node is head and tail at once.
+		}
 
 		this->headNode = nextNode;// save ref to added node.
 
 		size++; // increment the size of the linked list.
 	}
+
+	void insertAtTail(const V& data)
+	{
+		Node<V>* nextNode = createNode(data); // create node out of the given data.
+
+		if (this->tailNode == nullptr)
+		{
+			this->headNode = nextNode; // The head node mem. address points to the inserted node if the list is empty.
+		}
+		else
+		{
+			this->tailNode->next = nextNode; // modify the previous node to point to the next (now last) node.
+		}
+
+		this->tailNode = nextNode; // save ref to added node.
+
+		size++; // increment the size of the linked list.
+	}
+
+	/*
+	*	Moves all nodes of other behind the tail of this list in O(1), other is empty afterwards.
+	*	No node is copied or reallocated, so both lists must use equal allocators (the nodes are
+	*	freed by the allocator of the list they end up in); throws std::invalid_argument otherwise.
+	*/
+	void splice(LinkedList& other)
+	{
+		if (&other == this || other.headNode == nullptr)
+		{
+			return;
+		}
+		if (!(nodeAllocator == other.nodeAllocator))
+		{
+			throw std::invalid_argument("splice of linked lists with different allocators");
+		}
+
+		if (this->tailNode == nullptr)
+		{
+			this->headNode = other.headNode;
+		}
+		else
+		{
+			this->tailNode->next = other.headNode;
+		}
+		this->tailNode = other.tailNode;
+		this->size += other.size;
+
+		other.headNode = nullptr;
+		other.tailNode = nullptr;
+		other.size = 0;
+	}
 	
 	size_t deleteNodesGivenData(const V& data)
 	{
@@ -121,8 +278,13 @@ public:
 				{
 					// delete node somewhere in the linked list
 					prevNode->next = currNode->next;
-					delete currNode;
+					if (currNode == tailNode)
+					{
+						tailNode = prevNode;
+					}
+					destroyNode(currNode);
 					currNode = prevNode->next;
+					size--;
 				}
 				amountNodesDeleted++;
 			}
@@ -147,35 +309,462 @@ public:
 
 	void deleteAtHead()
 	{
+		if (this->headNode == nullptr)
+		{
+			return;
+		}
+
 		auto tempNext = this->headNode->next;
-		delete this->headNode;
+		destroyNode(this->headNode);
 		this->headNode = tempNext;
+		if (tempNext == nullptr)
+		{
+			this->tailNode = nullptr;
+		}
+		size--;
+	}
+
+	/*
+	*	Moves the head value into out and deletes the head node. Returns false (and leaves out
+	*	untouched) if the list is empty.
+	*/
+	bool popFront(V& out)
+	{
+		if (this->headNode == nullptr)
+		{
+			return false;
+		}
+
+		out = std::move(this->headNode->data);
+		deleteAtHead();
+		return true;
 	}
 
 	/*
+	*	Returns an iterator to the first value equal to data, end() if there is none.
 	*	Assumption: type V already implemented the == operator for comparisons.
 	*/
-	std::unique_ptr<Node<V>> getNode(const V& data)
+	iterator find(const V& data)
 	{
-		Node<V>* nextNode = this->headNode;
-		while (nextNode != nullptr)
+		return iterator(findNode(data));
+	}
+
+	const_iterator find(const V& data) const
+	{
+		return const_iterator(findNode(data));
+	}
+
+	/*
+	*	Returns the first node holding data, nullptr if there is none. The node is owned by
+	*	the list, the pointer is valid until that node is deleted.
+	*	Assumption: type V already implemented the == operator for comparisons.
+	*/
+	Node<V>* getNode(const V& data)
+	{
+		return findNode(data);
+	}
+
+	const Node<V>* getNode(const V& data) const
+	{
+		return findNode(data);
+	}
+
+	iterator begin()
+	{
+		return iterator(headNode);
+	}
+
+	iterator end()
+	{
+		return iterator();
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(headNode);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator();
+	}
+
+	const_iterator cbegin() const
+	{
+		return begin();
+	}
+
+	const_iterator cend() const
+	{
+		return end();
+	}
+
+	/*
+	*	Stable bottom-up merge sort that relinks the nodes: no allocation and no copies of V, so
+	*	iterators and node pointers stay valid and keep pointing at the same values.
+	*	Like std::list::sort, the nodes are fed one at a time into bins of sorted runs where bin i
+	*	holds 2^i nodes, and two runs of the same length are merged on the way up. O(n log n)
+	*	comparisons, O(1) extra space.
+	*	If comp throws, all nodes stay in the list (in an unspecified order) and the exception is
+	*	passed on.
+	*/
+	template<typename Compare = std::less<V>>
+	void sort(Compare comp = Compare())
+	{
+		Run list{ headNode, tailNode };
+		try
+		{
+			sortRun(list, comp);
+		}
+		catch (...)
+		{
+			headNode = list.head;
+			tailNode = list.tail;
+			throw;
+		}
+		headNode = list.head;
+		tailNode = list.tail;
+	}
+
+	/*
+	*	Same result as sort (stable, relinks nodes), but the list is cut into one chunk per thread,
+	*	the chunks are sorted concurrently and then merged pairwise, again in parallel, until one
+	*	run is left. Every thread uses its own copy of comp.
+	*	threadCount 0 means std::thread::hardware_concurrency(). Lists too short to be worth
+	*	starting threads for are sorted on the calling thread.
+	*/
+	template<typename Compare = std::less<V>>
+	void parallelSort(Compare comp = Compare(), size_t threadCount = 0)
+	{
+		static constexpr size_t MIN_NODES_PER_THREAD = 16384;
+
+		if (threadCount == 0)
 		{
-			if (nextNode->data == data)
+			threadCount = std::thread::hardware_concurrency();
+		}
+		if (threadCount > size / MIN_NODES_PER_THREAD)
+		{
+			threadCount = size / MIN_NODES_PER_THREAD;
+		}
+		if (threadCount < 2)
+		{
+			sort(comp);
+			return;
+		}
+
+		// cut the list into threadCount chunks of (almost) the same length
+		std::vector<Run> chunks(threadCount);
+		Node<V>* currNode = headNode;
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			const size_t chunkLength = size / threadCount + (i < size % threadCount ? 1 : 0);
+			chunks[i].head = currNode;
+			for (size_t j = 1; j < chunkLength; ++j)
 			{
-				return std::make_unique<Node<V>>(*nextNode);
+				currNode = currNode->next;
+			}
+			chunks[i].tail = currNode;
+			currNode = currNode->next;
+			chunks[i].tail->next = nullptr;
+		}
+
+		std::vector<std::exception_ptr> errors(threadCount);
+		runInParallel(threadCount, [&](const size_t i) {
+			Compare localComp = comp;
+			sortRun(chunks[i], localComp);
+		}, errors);
+
+		// merge neighbours until one run is left, older chunks stay in front (stability)
+		while (chunks.size() > 1 && !hasError(errors))
+		{
+			const size_t pairs = chunks.size() / 2;
+			runInParallel(pairs, [&](const size_t i) {
+				Compare localComp = comp;
+				mergeInto(chunks[2 * i], chunks[2 * i + 1], localComp);
+			}, errors);
+
+			size_t kept = 0;
+			for (size_t i = 0; i < chunks.size(); ++i)
+			{
+				if (chunks[i].head != nullptr)
+				{
+					chunks[kept++] = chunks[i];
+				}
+			}
+			chunks.resize(kept);
+		}
+
+		// after an error the chunks are concatenated, so the list keeps all of its nodes
+		Run list;
+		for (Run& chunk : chunks)
+		{
+			appendRun(list, chunk);
+		}
+		headNode = list.head;
+		tailNode = list.tail;
+
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
 			}
-			nextNode = nextNode->next;
 		}
-		std::cout << "Node with data: '" << data << "' does not exist." << std::endl;
-		return nullptr;
 	}
 
-	size_t getSize()
+	size_t getSize() const
 	{
 		return this->size;
 	}
 
+	bool empty() const
+	{
+		return this->headNode == nullptr;
+	}
+
+private:
+	// A sorted (or, after an exception, unsorted) chain of nodes, tail->next is always nullptr
+	struct Run
+	{
+		Node<V>* head = nullptr;
+		Node<V>* tail = nullptr;
+	};
+
+	static void appendRun(Run& front, Run& back)
+	{
+		if (back.head == nullptr)
+		{
+			return;
+		}
+		if (front.head == nullptr)
+		{
+			front.head = back.head;
+		}
+		else
+		{
+			front.tail->next = back.head;
+		}
+		front.tail = back.tail;
+		back = Run();
+	}
+
+	/*
+	*	Merges later into earlier; on equal values the nodes of earlier come first. later is
+	*	empty afterwards. If comp throws, earlier holds the nodes of both runs unsorted.
+	*/
+	template<typename Compare>
+	static void mergeInto(Run& earlier, Run& later, Compare& comp)
+	{
+		Node<V>* first = earlier.head;
+		Node<V>* second = later.head;
+		Node<V>* mergedHead = nullptr;
+		Node<V>* mergedTail = nullptr;
+		Node<V>** link = &mergedHead; // next pointer the next taken node is stored in
+		try
+		{
+			while (first != nullptr && second != nullptr)
+			{
+				if (comp(second->data, first->data))
+				{
+					*link = second;
+					mergedTail = second;
+					second = second->next;
+				}
+				else
+				{
+					*link = first;
+					mergedTail = first;
+					first = first->next;
+				}
+				link = &mergedTail->next;
+			}
+		}
+		catch (...)
+		{
+			// merged part, then the rest of both runs
+			Run merged{ mergedHead, mergedTail };
+			Run firstRest{ first, earlier.tail };
+			Run secondRest{ second, later.tail };
+			if (mergedTail != nullptr)
+			{
+				mergedTail->next = nullptr;
+			}
+			appendRun(merged, firstRest);
+			appendRun(merged, secondRest);
+			earlier = merged;
+			later = Run();
+			throw;
+		}
+
+		// the rest of one run is still linked, its tail is the tail of the merged run
+		if (first != nullptr)
+		{
+			*link = first;
+			mergedTail = earlier.tail;
+		}
+		else if (second != nullptr)
+		{
+			*link = second;
+			mergedTail = later.tail;
+		}
+		earlier.head = mergedHead;
+		earlier.tail = mergedTail;
+		later = Run();
+	}
+
+	/*
+	*	Sorts the nodes of list (bins of 2^i nodes, see sort). If comp throws, list holds all of
+	*	its nodes again, unsorted.
+	*/
+	template<typename Compare>
+	static void sortRun(Run& list, Compare& comp)
+	{
+		static constexpr size_t BIN_COUNT = 64;
+
+		Run bins[BIN_COUNT];
+		size_t binsUsed = 0;
+		Run carry;
+		Run result;
+		Run rest = list;
+		try
+		{
+			while (rest.head != nullptr)
+			{
+				carry.head = rest.head;
+				carry.tail = rest.head;
+				rest.head = rest.head->next;
+				carry.tail->next = nullptr;
+				if (rest.head == nullptr)
+				{
+					rest.tail = nullptr;
+				}
+
+				size_t i = 0;
+				for (; i < binsUsed && bins[i].head != nullptr; ++i)
+				{
+					mergeInto(bins[i], carry, comp);
+					carry = bins[i];
+					bins[i] = Run();
+				}
+				bins[i] = carry;
+				carry = Run();
+				if (i == binsUsed)
+				{
+					++binsUsed;
+				}
+			}
+
+			// the higher the bin, the earlier its nodes were in the list
+			for (size_t i = 0; i < binsUsed; ++i)
+			{
+				mergeInto(bins[i], result, comp);
+				result = bins[i];
+				bins[i] = Run();
+			}
+		}
+		catch (...)
+		{
+			Run restored;
+			appendRun(restored, result);
+			for (size_t i = 0; i < binsUsed; ++i)
+			{
+				appendRun(restored, bins[i]);
+			}
+			appendRun(restored, carry);
+			appendRun(restored, rest);
+			list = restored;
+			throw;
+		}
+		list = result;
+	}
+
+	/*
+	*	Runs task(0) .. task(taskCount - 1) on their own threads, an exception thrown by task i
+	*	lands in errors[i]. Tasks for which no thread can be started run on the calling thread.
+	*/
+	template<typename Task>
+	static void runInParallel(const size_t taskCount, Task task, std::vector<std::exception_ptr>& errors)
+	{
+		const auto guardedTask = [&task, &errors](const size_t i) {
+			try
+			{
+				task(i);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		size_t started = 0;
+		try
+		{
+			workers.reserve(taskCount);
+			for (; started < taskCount; ++started)
+			{
+				workers.emplace_back(guardedTask, started);
+			}
+		}
+		catch (...)
+		{
+			for (size_t i = started; i < taskCount; ++i)
+			{
+				guardedTask(i);
+			}
+		}
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	static bool hasError(const std::vector<std::exception_ptr>& errors)
+	{
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Node<V>* findNode(const V& data) const
+	{
+		Node<V>* nextNode = this->headNode;
+		while (nextNode != nullptr && !(nextNode->data == data))
+		{
+			nextNode = nextNode->next;
+		}
+		return nextNode;
+	}
+
+	Node<V>* createNode(const V& data)
+	{
+		Node<V>* node = NodeAllocatorTraits::allocate(nodeAllocator, 1);
+		try
+		{
+			NodeAllocatorTraits::construct(nodeAllocator, node, data);
+		}
+		catch (...)
+		{
+			NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void destroyNode(Node<V>* node)
+	{
+		NodeAllocatorTraits::destroy(nodeAllocator, node);
+		NodeAllocatorTraits::deallocate(nodeAllocator, node, 1);
+	}
+
 private:
+	NodeAllocator nodeAllocator;
 	Node<V>* headNode;
+	Node<V>* tailNode;
 	size_t size;
 };
\ No newline at end of file
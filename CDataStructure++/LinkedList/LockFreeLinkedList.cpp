@@ -0,0 +1 @@
+#include <LockFreeLinkedList.h>
\ No newline at end of file
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include "AtomicNode.h"
+#include "EpochManager.h"
+
+/*
+*	Default ordering of LockFreeLinkedList: operator< and operator== of T.
+*	precedes(nodeData, target) tells the search to keep walking, equals(nodeData, target) tells
+*	whether the node it stopped at is the target. Custom orderings may take any probe type as
+*	target, so a lookup doesn't have to build a whole T.
+*/
+template<typename T>
+struct LockFreeListOrdering
+{
+	static bool precedes(const T& nodeData, const T& target)
+	{
+		return nodeData < target;
+	}
+
+	static bool equals(const T& nodeData, const T& target)
+	{
+		return nodeData == target;
+	}
+};
+
+/*
+*	Lock-free sorted singly linked list (Harris/Michael) of unique values.
+*	remove first marks the next pointer of a node (logical delete) and then unlinks it; a search
+*	that runs into a marked node helps unlinking it. Whoever unlinks a node retires it to the
+*	EpochManager, which frees it once no pinned thread can still be looking at it.
+*
+*	Besides the whole-list API, the *From functions start at an arbitrary node that is never
+*	removed. LockFreeHashTable uses those with its bucket sentinels.
+*/
+template<typename T, typename Ordering = LockFreeListOrdering<T>>
+class LockFreeLinkedList
+{
+public:
+	using NodeType = AtomicNode<T>;
+
+public:
+	LockFreeLinkedList()
+		:
+		headNode(new NodeType()),
+		size(0)
+	{
+	}
+
+	LockFreeLinkedList(const LockFreeLinkedList&) = delete;
+	LockFreeLinkedList(LockFreeLinkedList&&) = delete;
+
+	~LockFreeLinkedList()
+	{
+		// No other thread may use the list anymore, so nodes are deleted directly
+		NodeType* currNode = headNode;
+		while (currNode != nullptr)
+		{
+			NodeType* nextNode = NodeType::unmarked(currNode->next.load(std::memory_order_relaxed));
+			delete currNode;
+			currNode = nextNode;
+		}
+	}
+
+	bool insert(const T& data)
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		NodeType* node = new NodeType(data);
+		if (insertFrom(headNode, node, data) != node)
+		{
+			delete node;
+			return false;
+		}
+		size.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool remove(const T& data)
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		if (removeFrom(headNode, data))
+		{
+			size.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	bool contains(const T& data) const
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		return findFrom(headNode, data) != nullptr;
+	}
+
+	size_t getSize() const
+	{
+		return size.load(std::memory_order_relaxed);
+	}
+
+	NodeType* getHead() const
+	{
+		return headNode;
+	}
+
+	/*
+	*	Links node in after start unless a node equal to target already exists.
+	*	Returns node on success, the existing node otherwise (node is then not linked).
+	*	The caller must be pinned.
+	*/
+	template<typename Probe>
+	NodeType* insertFrom(NodeType* start, NodeType* node, const Probe& target)
+	{
+		while (true)
+		{
+			NodeType* prevNode;
+			NodeType* currNode;
+			if (search(start, target, prevNode, currNode))
+			{
+				return currNode;
+			}
+
+			node->next.store(currNode, std::memory_order_relaxed);
+			if (prevNode->next.compare_exchange_weak(currNode, node, std::memory_order_release, std::memory_order_relaxed))
+			{
+				return node;
+			}
+		}
+	}
+
+	/*
+	*	Removes the node equal to target that comes after start. The caller must be pinned.
+	*/
+	template<typename Probe>
+	bool removeFrom(NodeType* start, const Probe& target)
+	{
+		while (true)
+		{
+			NodeType* prevNode;
+			NodeType* currNode;
+			if (!search(start, target, prevNode, currNode))
+			{
+				return false;
+			}
+
+			NodeType* nextNode = currNode->next.load(std::memory_order_acquire);
+			if (NodeType::isMarked(nextNode))
+			{
+				continue;
+			}
+
+			// logical delete; losing this race means somebody else changed currNode first
+			if (!currNode->next.compare_exchange_strong(nextNode, NodeType::marked(nextNode), std::memory_order_acq_rel))
+			{
+				continue;
+			}
+
+			if (prevNode->next.compare_exchange_strong(currNode, nextNode, std::memory_order_acq_rel))
+			{
+				EpochManager::instance().retire(currNode);
+			}
+			else
+			{
+				// let a search do the unlinking (and retiring)
+				search(start, target, prevNode, currNode);
+			}
+			return true;
+		}
+	}
+
+	/*
+	*	Read-only lookup: skips marked nodes instead of helping to unlink them, so it never writes
+	*	to shared memory and never restarts. The caller must be pinned.
+	*/
+	template<typename Probe>
+	NodeType* findFrom(NodeType* start, const Probe& target) const
+	{
+		NodeType* currNode = NodeType::unmarked(start->next.load(std::memory_order_acquire));
+		while (currNode != nullptr && Ordering::precedes(currNode->data, target))
+		{
+			currNode = NodeType::unmarked(currNode->next.load(std::memory_order_acquire));
+		}
+
+		if (currNode != nullptr
+			&& Ordering::equals(currNode->data, target)
+			&& !NodeType::isMarked(currNode->next.load(std::memory_order_acquire)))
+		{
+			return currNode;
+		}
+		return nullptr;
+	}
+
+private:
+	/*
+	*	Finds the window prevNode -> currNode where currNode is the first node that does not
+	*	precede target, unlinking marked nodes on the way. Returns whether currNode equals target.
+	*/
+	template<typename Probe>
+	bool search(NodeType* start, const Probe& target, NodeType*& prevNode, NodeType*& currNode)
+	{
+	retry:
+		prevNode = start;
+		currNode = prevNode->next.load(std::memory_order_acquire);
+
+		while (true)
+		{
+			if (currNode == nullptr)
+			{
+				return false;
+			}
+
+			NodeType* nextNode = currNode->next.load(std::memory_order_acquire);
+			if (NodeType::isMarked(nextNode))
+			{
+				// fails if prevNode got marked or changed meanwhile, then start over
+				if (!prevNode->next.compare_exchange_strong(currNode, NodeType::unmarked(nextNode), std::memory_order_acq_rel))
+				{
+					goto retry;
+				}
+				EpochManager::instance().retire(currNode);
+				currNode = NodeType::unmarked(nextNode);
+				continue;
+			}
+
+			if (!Ordering::precedes(currNode->data, target))
+			{
+				return Ordering::equals(currNode->data, target);
+			}
+
+			prevNode = currNode;
+			currNode = nextNode;
+		}
+	}
+
+private:
+	NodeType* headNode; // sentinel, never removed
+	std::atomic<size_t> size;
+};
@@ -0,0 +1 @@
+#include <LockFreeQueue.h>
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "AtomicNode.h"
+#include "EpochManager.h"
+
+/*
+*	Lock-free multi-producer multi-consumer FIFO queue (Michael, Scott: "Simple, Fast, and
+*	Practical Non-Blocking and Blocking Concurrent Queue Algorithms").
+*
+*	The list always starts with a dummy node: headNode points to the dummy, the first value
+*	lives in the node after it. Producers CAS their node behind the last node and then swing
+*	tailNode; a thread that finds tailNode lagging behind swings it for them, so no thread ever
+*	waits for another. A successful dequeue turns the first value node into the new dummy and
+*	retires the old one to the EpochManager, which also keeps the head and tail CAS loops free
+*	of ABA (see LockFreeStack).
+*	head and tail sit on separate cache lines, so producers and consumers don't contend unless
+*	the queue is (nearly) empty.
+*/
+template<typename T>
+class LockFreeQueue
+{
+public:
+	using NodeType = AtomicNode<T>;
+
+public:
+	LockFreeQueue()
+	{
+		NodeType* dummy = new NodeType();
+		headNode.store(dummy, std::memory_order_relaxed);
+		tailNode.store(dummy, std::memory_order_relaxed);
+	}
+
+	// Delete constructors which may cause headache and bugs
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue(LockFreeQueue&&) = delete;
+
+	~LockFreeQueue()
+	{
+		// No other thread may use the queue anymore, so nodes are deleted directly
+		NodeType* currNode = headNode.load(std::memory_order_relaxed);
+		while (currNode != nullptr)
+		{
+			NodeType* nextNode = currNode->next.load(std::memory_order_relaxed);
+			delete currNode;
+			currNode = nextNode;
+		}
+	}
+
+	void enqueue(const T& data)
+	{
+		NodeType* node = new NodeType(data);
+
+		EpochManager::Guard guard(EpochManager::instance());
+		while (true)
+		{
+			NodeType* tail = tailNode.load(std::memory_order_acquire);
+			NodeType* nextNode = tail->next.load(std::memory_order_acquire);
+			if (tail != tailNode.load(std::memory_order_acquire))
+			{
+				continue;
+			}
+
+			if (nextNode == nullptr)
+			{
+				if (tail->next.compare_exchange_weak(nextNode, node, std::memory_order_release, std::memory_order_relaxed))
+				{
+					// may fail if another thread already helped, either way tail moved on
+					tailNode.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+					return;
+				}
+			}
+			else
+			{
+				// tail is lagging behind, help the other producer
+				tailNode.compare_exchange_weak(tail, nextNode, std::memory_order_release, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/*
+	*	Moves the oldest value into out. Returns false (and leaves out untouched) if the queue is
+	*	empty.
+	*/
+	bool dequeue(T& out)
+	{
+		EpochManager& epochs = EpochManager::instance();
+		EpochManager::Guard guard(epochs);
+		while (true)
+		{
+			NodeType* head = headNode.load(std::memory_order_acquire);
+			NodeType* tail = tailNode.load(std::memory_order_acquire);
+			NodeType* nextNode = head->next.load(std::memory_order_acquire);
+			if (head != headNode.load(std::memory_order_acquire))
+			{
+				continue;
+			}
+
+			if (nextNode == nullptr)
+			{
+				return false;
+			}
+
+			if (head == tail)
+			{
+				// a value was linked but tail still points at the dummy, move it first so
+				// headNode never passes tailNode
+				tailNode.compare_exchange_weak(tail, nextNode, std::memory_order_release, std::memory_order_relaxed);
+				continue;
+			}
+
+			if (headNode.compare_exchange_weak(head, nextNode, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				// nextNode is the new dummy; its value belongs to the thread that won the CAS
+				out = std::move(nextNode->data);
+				epochs.retire(head);
+				return true;
+			}
+		}
+	}
+
+	// A snapshot, may be outdated as soon as it returns
+	bool empty() const
+	{
+		EpochManager::Guard guard(EpochManager::instance());
+		return headNode.load(std::memory_order_acquire)->next.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+	alignas(64) std::atomic<NodeType*> headNode;
+	alignas(64) std::atomic<NodeType*> tailNode;
+};
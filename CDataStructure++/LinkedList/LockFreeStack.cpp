@@ -0,0 +1 @@
+#include <LockFreeStack.h>
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "AtomicNode.h"
+#include "EpochManager.h"
+
+/*
+*	Lock-free LIFO stack (Treiber). push and pop swing the top pointer with a single
+*	compare-and-swap, any number of threads may push and pop at the same time.
+*
+*	Popped nodes are retired to the EpochManager instead of deleted. That is what makes the pop
+*	CAS safe against ABA: while a thread is pinned with a top node loaded, that node can't be
+*	freed and handed out again by a push, so "top is still the same address" really means
+*	"top is still the same node".
+*/
+template<typename T>
+class LockFreeStack
+{
+public:
+	using NodeType = AtomicNode<T>;
+
+public:
+	LockFreeStack()
+		:
+		topNode(nullptr)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	LockFreeStack(const LockFreeStack&) = delete;
+	LockFreeStack(LockFreeStack&&) = delete;
+
+	~LockFreeStack()
+	{
+		// No other thread may use the stack anymore, so nodes are deleted directly
+		NodeType* currNode = topNode.load(std::memory_order_relaxed);
+		while (currNode != nullptr)
+		{
+			NodeType* nextNode = currNode->next.load(std::memory_order_relaxed);
+			delete currNode;
+			currNode = nextNode;
+		}
+	}
+
+	void push(const T& data)
+	{
+		// the new node is private until the CAS publishes it, no pinning needed
+		NodeType* node = new NodeType(data);
+		NodeType* top = topNode.load(std::memory_order_relaxed);
+		do
+		{
+			node->next.store(top, std::memory_order_relaxed);
+		} while (!topNode.compare_exchange_weak(top, node, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/*
+	*	Moves the top value into out. Returns false (and leaves out untouched) if the stack is
+	*	empty.
+	*/
+	bool pop(T& out)
+	{
+		EpochManager& epochs = EpochManager::instance();
+		EpochManager::Guard guard(epochs);
+
+		NodeType* top = topNode.load(std::memory_order_acquire);
+		while (top != nullptr)
+		{
+			NodeType* nextNode = top->next.load(std::memory_order_relaxed);
+			if (topNode.compare_exchange_weak(top, nextNode, std::memory_order_acquire, std::memory_order_acquire))
+			{
+				// only the thread that unlinked the node touches its value
+				out = std::move(top->data);
+				epochs.retire(top);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// A snapshot, may be outdated as soon as it returns
+	bool empty() const
+	{
+		return topNode.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+	alignas(64) std::atomic<NodeType*> topNode;
+};
@@ -27,13 +27,6 @@ public:
 	{
 	}
 
-	~Node()
-	{
-		if (this->next != nullptr) {
-			this->next = nullptr;
-		}
-	}
-
 	friend std::ostream& operator<<(std::ostream& stream, const Node& node)
 	{
 		stream << "Node Addr: " << &node << ", Node Data: " << node.data << ", Node Next Addr: " << node.next;
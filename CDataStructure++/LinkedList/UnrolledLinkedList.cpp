@@ -0,0 +1 @@
+#include <UnrolledLinkedList.h>
\ No newline at end of file
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "../Allocator/PoolAllocator.h"
+
+/*
+*	Linked list that packs up to ELEMENTS_PER_BLOCK values into every node (block) of about
+*	BlockBytes bytes, instead of one value plus a next pointer per heap node like LinkedList.
+*	A scan follows one pointer per block and reads the values of a block from consecutive
+*	memory, and the per element overhead drops from a pointer (plus malloc header) to a fraction
+*	of the block header.
+*
+*	Every block keeps its values in slots [begin, end). insertAtHead fills the head block from
+*	the back, so it stays O(1). deleteNodesGivenData repacks the surviving values in the same
+*	pass, so the blocks stay full no matter how many values are deleted.
+*	Same insert/delete/search API as LinkedList; find returns a pointer to the value instead of
+*	a node.
+*/
+template<typename V, typename Allocator = std::allocator<V>, size_t BlockBytes = 128>
+class UnrolledLinkedList
+{
+private:
+	struct BlockHeader
+	{
+		void* next;
+		uint32_t begin;
+		uint32_t end;
+	};
+
+public:
+	static constexpr size_t ELEMENTS_PER_BLOCK = BlockBytes > sizeof(BlockHeader) + sizeof(V)
+		? (BlockBytes - sizeof(BlockHeader)) / sizeof(V)
+		: 1;
+
+private:
+	struct Block
+	{
+		Block* next;
+		uint32_t begin; // first used slot
+		uint32_t end;	// one past the last used slot
+		typename std::aligned_storage<sizeof(V), alignof(V)>::type slots[ELEMENTS_PER_BLOCK];
+
+		V& at(const size_t idx)
+		{
+			return *std::launder(reinterpret_cast<V*>(&slots[idx]));
+		}
+
+		V* values()
+		{
+			return std::launder(reinterpret_cast<V*>(slots));
+		}
+	};
+
+	using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+	using BlockAllocatorTraits = std::allocator_traits<BlockAllocator>;
+
+public:
+	explicit UnrolledLinkedList(const Allocator& allocator = Allocator())
+		:
+		blockAllocator(allocator),
+		headBlock(nullptr),
+		size(0)
+	{
+	}
+
+	UnrolledLinkedList(const V& data, const Allocator& allocator = Allocator())
+		:
+		UnrolledLinkedList(allocator)
+	{
+		insertAtHead(data);
+	}
+
+	// Delete constructors which may cause headache and bugs
+	UnrolledLinkedList(const UnrolledLinkedList&) = delete;
+	UnrolledLinkedList(UnrolledLinkedList&&) = delete;
+
+	~UnrolledLinkedList()
+	{
+		// with a pool of its own the slabs are freed wholesale, no need to visit every block
+		if (!(std::is_trivially_destructible<V>::value && poolFreesInBulk<Block>(blockAllocator)))
+		{
+			clear();
+		}
+	}
+
+	void insertAtHead(const V& data)
+	{
+		if (headBlock == nullptr || headBlock->begin == 0)
+		{
+			// the new head block is filled from its last slot
+			Block* block = allocateBlock();
+			try
+			{
+				new (&block->slots[ELEMENTS_PER_BLOCK - 1]) V(data);
+			}
+			catch (...)
+			{
+				deallocateBlock(block);
+				throw;
+			}
+			block->next = headBlock;
+			block->begin = ELEMENTS_PER_BLOCK - 1;
+			block->end = ELEMENTS_PER_BLOCK;
+			headBlock = block;
+		}
+		else
+		{
+			new (&headBlock->slots[headBlock->begin - 1]) V(data);
+			--headBlock->begin;
+		}
+		++size;
+	}
+
+	/*
+	*	Deletes every value equal to data and returns how many were deleted. The survivors are
+	*	moved forward (keeping their order) into the slots that became free, and blocks that end
+	*	up empty are freed.
+	*/
+	size_t deleteNodesGivenData(const V& data)
+	{
+		if (headBlock == nullptr)
+		{
+			return 0;
+		}
+
+		// write cursor: block and slot the next surviving value moves to
+		Block* writeBlock = headBlock;
+		size_t writeIdx = headBlock->begin;
+		size_t deleted = 0;
+
+		for (Block* readBlock = headBlock; readBlock != nullptr; readBlock = readBlock->next)
+		{
+			const size_t readEnd = readBlock->end;
+			V* values = readBlock->values();
+			for (size_t readIdx = readBlock->begin; readIdx < readEnd; ++readIdx)
+			{
+				V& value = values[readIdx];
+				if (value == data)
+				{
+					value.~V();
+					++deleted;
+					continue;
+				}
+
+				if (writeIdx == ELEMENTS_PER_BLOCK)
+				{
+					writeBlock->end = ELEMENTS_PER_BLOCK;
+					writeBlock = writeBlock->next;
+					writeBlock->begin = 0;
+					writeIdx = 0;
+				}
+
+				if (writeBlock != readBlock || writeIdx != readIdx)
+				{
+					new (&writeBlock->slots[writeIdx]) V(std::move(value));
+					value.~V();
+				}
+				++writeIdx;
+			}
+		}
+
+		size -= deleted;
+		writeBlock->end = static_cast<uint32_t>(writeIdx);
+
+		// everything behind the write cursor is unused now
+		Block* unused = writeBlock->next;
+		writeBlock->next = nullptr;
+		while (unused != nullptr)
+		{
+			Block* next = unused->next;
+			deallocateBlock(unused);
+			unused = next;
+		}
+		if (size == 0)
+		{
+			deallocateBlock(headBlock);
+			headBlock = nullptr;
+		}
+		return deleted;
+	}
+
+	void deleteAtHead()
+	{
+		if (headBlock == nullptr)
+		{
+			return;
+		}
+
+		headBlock->at(headBlock->begin).~V();
+		++headBlock->begin;
+		--size;
+		if (headBlock->begin == headBlock->end)
+		{
+			Block* next = headBlock->next;
+			deallocateBlock(headBlock);
+			headBlock = next;
+		}
+	}
+
+	/*
+	*	Returns the first value equal to data or nullptr.
+	*	Assumption: type V already implemented the == operator for comparisons.
+	*/
+	V* find(const V& data)
+	{
+		for (Block* block = headBlock; block != nullptr; block = block->next)
+		{
+			// bounds in locals: stores to V could alias the header, the compiler would reload them
+			const size_t begin = block->begin;
+			const size_t end = block->end;
+			V* values = block->values();
+
+			// test the whole block without an early exit first, that loop vectorizes
+			bool hit = false;
+			for (size_t idx = begin; idx < end; ++idx)
+			{
+				hit |= values[idx] == data;
+			}
+
+			if (hit)
+			{
+				for (size_t idx = begin; idx < end; ++idx)
+				{
+					if (values[idx] == data)
+					{
+						return &values[idx];
+					}
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	bool contains(const V& data)
+	{
+		return find(data) != nullptr;
+	}
+
+	/*
+	*	Calls func(value) for every value from head to tail.
+	*/
+	template<typename Func>
+	void forEach(Func func)
+	{
+		for (Block* block = headBlock; block != nullptr; block = block->next)
+		{
+			const size_t end = block->end;
+			V* values = block->values();
+			for (size_t idx = block->begin; idx < end; ++idx)
+			{
+				func(values[idx]);
+			}
+		}
+	}
+
+	void clear()
+	{
+		while (headBlock != nullptr)
+		{
+			Block* next = headBlock->next;
+			for (size_t idx = headBlock->begin; idx < headBlock->end; ++idx)
+			{
+				headBlock->at(idx).~V();
+			}
+			deallocateBlock(headBlock);
+			headBlock = next;
+		}
+		size = 0;
+	}
+
+	size_t getSize() const
+	{
+		return size;
+	}
+
+	bool empty() const
+	{
+		return size == 0;
+	}
+
+	size_t getBlockCount() const
+	{
+		size_t blocks = 0;
+		for (const Block* block = headBlock; block != nullptr; block = block->next)
+		{
+			++blocks;
+		}
+		return blocks;
+	}
+
+	// Bytes of all blocks, the memory the values take including the list overhead
+	size_t getMemoryUsage() const
+	{
+		return getBlockCount() * sizeof(Block);
+	}
+
+private:
+	// Only the header is set up by the caller, the slots stay uninitialized
+	Block* allocateBlock()
+	{
+		return ::new (static_cast<void*>(BlockAllocatorTraits::allocate(blockAllocator, 1))) Block;
+	}
+
+	// The values of the block must already be destroyed or moved out
+	void deallocateBlock(Block* block)
+	{
+		BlockAllocatorTraits::deallocate(blockAllocator, block, 1);
+	}
+
+private:
+	BlockAllocator blockAllocator;
+	Block* headBlock;
+	size_t size;
+};
@@ -0,0 +1 @@
+#include <MPMCRingBuffer.h>
\ No newline at end of file
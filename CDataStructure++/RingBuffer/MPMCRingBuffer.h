@@ -0,0 +1,235 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "RingBufferDetail.h"
+
+/*
+*	Bounded multi-producer multi-consumer FIFO (Vyukov's bounded queue): every slot carries a
+*	sequence number that tells whose turn it is. For the slot of position pos:
+*		sequence == pos				free, the producer that claims pos may write it
+*		sequence == pos + 1			full, the consumer that claims pos may read it
+*		sequence == pos + capacity	read, free again for the producer one lap later
+*	Producers claim positions by a CAS on enqueuePosition, consumers on dequeuePosition; the
+*	sequence store after writing/reading hands the slot over. A thread never waits for another,
+*	only a full or empty ring makes try_push / try_pop fail.
+*	try_push_n / try_pop_n claim a run of consecutive slots with a single CAS.
+*	A claimed slot can't be handed back, a consumer would wait on it forever, so T must be
+*	nothrow copy constructible: the value is built only after the CAS has claimed its slot.
+*/
+template<typename T>
+class MPMCRingBuffer
+{
+	static_assert(std::is_nothrow_copy_constructible<T>::value, "MPMCRingBuffer requires a nothrow copy constructible T");
+
+public:
+	explicit MPMCRingBuffer(const size_t capacity)
+		:
+		slotCount(ring_detail::slotCountFor(capacity)),
+		mask(slotCount - 1),
+		slots(new Slot[slotCount]),
+		enqueuePosition(0),
+		dequeuePosition(0)
+	{
+		for (size_t i = 0; i < slotCount; ++i)
+		{
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// Delete constructors which may cause headache and bugs
+	MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+	MPMCRingBuffer(MPMCRingBuffer&&) = delete;
+
+	~MPMCRingBuffer()
+	{
+		const size_t tail = enqueuePosition.load(std::memory_order_relaxed);
+		for (size_t head = dequeuePosition.load(std::memory_order_relaxed); head != tail; ++head)
+		{
+			slots[head & mask].value().~T();
+		}
+	}
+
+	// Returns false if the ring is full
+	bool try_push(const T& value)
+	{
+		size_t position = enqueuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Slot& slot = slots[position & mask];
+			const intptr_t lag = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire) - position);
+			if (lag == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					new (&slot.storage) T(value);
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (lag < 0)
+			{
+				// the slot still holds the value of the previous lap
+				return false;
+			}
+			else
+			{
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/*
+	*	Pushes as many of values[0, count) as there are free consecutive slots and returns how
+	*	many that were. The run is claimed with one CAS, its elements stay in order.
+	*/
+	size_t try_push_n(const T* values, const size_t count)
+	{
+		size_t position = enqueuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			size_t run = 0;
+			while (run < count && slots[(position + run) & mask].sequence.load(std::memory_order_acquire) == position + run)
+			{
+				++run;
+			}
+			if (run == 0)
+			{
+				const intptr_t lag = static_cast<intptr_t>(slots[position & mask].sequence.load(std::memory_order_acquire) - position);
+				if (count == 0 || lag < 0)
+				{
+					return 0;
+				}
+				position = enqueuePosition.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			// no other producer can take the checked slots without moving enqueuePosition first
+			if (enqueuePosition.compare_exchange_weak(position, position + run, std::memory_order_relaxed))
+			{
+				for (size_t i = 0; i < run; ++i)
+				{
+					Slot& slot = slots[(position + i) & mask];
+					new (&slot.storage) T(values[i]);
+					slot.sequence.store(position + i + 1, std::memory_order_release);
+				}
+				return run;
+			}
+		}
+	}
+
+	// Moves the oldest element into out, returns false if the ring is empty
+	bool try_pop(T& out)
+	{
+		size_t position = dequeuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Slot& slot = slots[position & mask];
+			const intptr_t lag = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire) - (position + 1));
+			if (lag == 0)
+			{
+				if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					T& value = slot.value();
+					out = std::move(value);
+					value.~T();
+					slot.sequence.store(position + slotCount, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (lag < 0)
+			{
+				// nothing written to the slot yet
+				return false;
+			}
+			else
+			{
+				position = dequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/*
+	*	Moves up to maxCount of the oldest elements to out[0, ...) and returns how many that were.
+	*	Stops at the first slot whose producer hasn't finished writing yet.
+	*/
+	size_t try_pop_n(T* out, const size_t maxCount)
+	{
+		size_t position = dequeuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			size_t run = 0;
+			while (run < maxCount && slots[(position + run) & mask].sequence.load(std::memory_order_acquire) == position + run + 1)
+			{
+				++run;
+			}
+			if (run == 0)
+			{
+				const intptr_t lag = static_cast<intptr_t>(slots[position & mask].sequence.load(std::memory_order_acquire) - (position + 1));
+				if (maxCount == 0 || lag < 0)
+				{
+					return 0;
+				}
+				position = dequeuePosition.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (dequeuePosition.compare_exchange_weak(position, position + run, std::memory_order_relaxed))
+			{
+				for (size_t i = 0; i < run; ++i)
+				{
+					Slot& slot = slots[(position + i) & mask];
+					T& value = slot.value();
+					out[i] = std::move(value);
+					value.~T();
+					slot.sequence.store(position + i + slotCount, std::memory_order_release);
+				}
+				return run;
+			}
+		}
+	}
+
+	// A snapshot, may be outdated as soon as it returns
+	size_t size() const
+	{
+		const size_t head = dequeuePosition.load(std::memory_order_acquire);
+		const size_t tail = enqueuePosition.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return slotCount;
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		ring_detail::SlotStorage<T> storage;
+
+		T& value()
+		{
+			return *std::launder(reinterpret_cast<T*>(&storage));
+		}
+	};
+
+private:
+	const size_t slotCount;
+	const size_t mask;
+	std::unique_ptr<Slot[]> slots;
+
+	alignas(ring_detail::CACHE_LINE) std::atomic<size_t> enqueuePosition;
+	alignas(ring_detail::CACHE_LINE) std::atomic<size_t> dequeuePosition;
+};
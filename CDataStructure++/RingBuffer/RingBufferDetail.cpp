@@ -0,0 +1 @@
+#include <RingBufferDetail.h>
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace ring_detail
+{
+	// Producer and consumer indices go on separate lines, so they don't invalidate each other
+	constexpr size_t CACHE_LINE = 64;
+
+	// Capacity rounded up to a power of two (at least 2), so a position maps to its slot with a mask
+	inline size_t slotCountFor(const size_t capacity)
+	{
+		size_t slotCount = 2;
+		while (slotCount < capacity)
+		{
+			slotCount <<= 1;
+		}
+		return slotCount;
+	}
+
+	// Uninitialized storage for one element, constructed on push and destroyed on pop
+	template<typename T>
+	using SlotStorage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+}
@@ -0,0 +1 @@
+#include <SPSCRingBuffer.h>
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include "RingBufferDetail.h"
+
+/*
+*	Bounded single-producer single-consumer FIFO on a power of two ring of slots.
+*	Exactly one thread may push and exactly one (other) thread may pop. Each side owns one index
+*	and only publishes it with a release store, the other side reads it with an acquire load: no
+*	read-modify-write and no lock anywhere.
+*	Both sides also keep a cached copy of the other index and only reload the shared one when the
+*	cached value says the ring is full (producer) or empty (consumer), so in steady state a push
+*	or pop touches no cache line written by the other thread except the slot itself.
+*	The batched try_push_n / try_pop_n move many elements with a single index update.
+*/
+template<typename T>
+class SPSCRingBuffer
+{
+public:
+	explicit SPSCRingBuffer(const size_t capacity)
+		:
+		slotCount(ring_detail::slotCountFor(capacity)),
+		mask(slotCount - 1),
+		slots(new ring_detail::SlotStorage<T>[slotCount]),
+		tailIndex(0),
+		cachedHeadIndex(0),
+		headIndex(0),
+		cachedTailIndex(0)
+	{
+	}
+
+	// Delete constructors which may cause headache and bugs
+	SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+	SPSCRingBuffer(SPSCRingBuffer&&) = delete;
+
+	~SPSCRingBuffer()
+	{
+		const size_t tail = tailIndex.load(std::memory_order_relaxed);
+		for (size_t head = headIndex.load(std::memory_order_relaxed); head != tail; ++head)
+		{
+			at(head).~T();
+		}
+	}
+
+	// Producer only. Returns false if the ring is full.
+	bool try_push(const T& value)
+	{
+		const size_t tail = tailIndex.load(std::memory_order_relaxed);
+		if (tail - cachedHeadIndex == slotCount)
+		{
+			cachedHeadIndex = headIndex.load(std::memory_order_acquire);
+			if (tail - cachedHeadIndex == slotCount)
+			{
+				return false;
+			}
+		}
+
+		new (&slots[tail & mask]) T(value);
+		tailIndex.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*
+	*	Producer only. Pushes as many of values[0, count) as fit and returns how many that were,
+	*	the consumer sees all of them at once.
+	*/
+	size_t try_push_n(const T* values, const size_t count)
+	{
+		const size_t tail = tailIndex.load(std::memory_order_relaxed);
+		size_t freeSlots = slotCount - (tail - cachedHeadIndex);
+		if (freeSlots < count)
+		{
+			cachedHeadIndex = headIndex.load(std::memory_order_acquire);
+			freeSlots = slotCount - (tail - cachedHeadIndex);
+		}
+
+		const size_t pushed = count < freeSlots ? count : freeSlots;
+		size_t built = 0;
+		try
+		{
+			for (; built < pushed; ++built)
+			{
+				new (&slots[(tail + built) & mask]) T(values[built]);
+			}
+		}
+		catch (...)
+		{
+			// publish the elements constructed before the throw so they are popped and destroyed
+			tailIndex.store(tail + built, std::memory_order_release);
+			throw;
+		}
+		if (pushed > 0)
+		{
+			tailIndex.store(tail + pushed, std::memory_order_release);
+		}
+		return pushed;
+	}
+
+	// Consumer only. Moves the oldest element into out, returns false if the ring is empty.
+	bool try_pop(T& out)
+	{
+		const size_t head = headIndex.load(std::memory_order_relaxed);
+		if (head == cachedTailIndex)
+		{
+			cachedTailIndex = tailIndex.load(std::memory_order_acquire);
+			if (head == cachedTailIndex)
+			{
+				return false;
+			}
+		}
+
+		T& value = at(head);
+		out = std::move(value);
+		value.~T();
+		headIndex.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*
+	*	Consumer only. Moves up to maxCount of the oldest elements to out[0, ...) and returns how
+	*	many that were; their slots are handed back to the producer at once.
+	*/
+	size_t try_pop_n(T* out, const size_t maxCount)
+	{
+		const size_t head = headIndex.load(std::memory_order_relaxed);
+		size_t available = cachedTailIndex - head;
+		if (available < maxCount)
+		{
+			cachedTailIndex = tailIndex.load(std::memory_order_acquire);
+			available = cachedTailIndex - head;
+		}
+
+		const size_t popped = maxCount < available ? maxCount : available;
+		for (size_t i = 0; i < popped; ++i)
+		{
+			T& value = at(head + i);
+			out[i] = std::move(value);
+			value.~T();
+		}
+		if (popped > 0)
+		{
+			headIndex.store(head + popped, std::memory_order_release);
+		}
+		return popped;
+	}
+
+	// A snapshot, exact only when called by the producer or consumer while the other side is idle
+	size_t size() const
+	{
+		const size_t head = headIndex.load(std::memory_order_acquire);
+		return tailIndex.load(std::memory_order_acquire) - head;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	size_t getCapacity() const
+	{
+		return slotCount;
+	}
+
+private:
+	T& at(const size_t position)
+	{
+		return *std::launder(reinterpret_cast<T*>(&slots[position & mask]));
+	}
+
+private:
+	const size_t slotCount;
+	const size_t mask;
+	std::unique_ptr<ring_detail::SlotStorage<T>[]> slots;
+
+	// written by the producer
+	alignas(ring_detail::CACHE_LINE) std::atomic<size_t> tailIndex;
+	size_t cachedHeadIndex;
+
+	// written by the consumer
+	alignas(ring_detail::CACHE_LINE) std::atomic<size_t> headIndex;
+	size_t cachedTailIndex;
+};
@@ -1,14 +1,36 @@
 #include <HashTable.h>
+#include <FlatHashTable.h>
+#include <SwissHashTable.h>
+#include <StringHashTable.h>
+#include <ConcurrentHashTable.h>
+#include <LockFreeHashTable.h>
+#include <BoundedCache.h>
+#include <MappedHashTable.h>
 #include <LinkedList.h>
+#include <UnrolledLinkedList.h>
+#include <LockFreeQueue.h>
+#include <LockFreeStack.h>
 #include <Timer.h>
 #include <BinarySearchTree.h>
 #include <AVLTree.h>
+#include <BlockedBloomFilter.h>
+#include <PoolAllocator.h>
+#include <SPSCRingBuffer.h>
+#include <MPMCRingBuffer.h>
 #include <random>
 #include <iostream>
 #include <functional>
 #include <algorithm>
+#include <limits>
+#include <chrono>
 #include <exception>
 #include <vector>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
 
 const std::string randomStrGen(const size_t &length, const size_t &rndNum)
 {
@@ -56,6 +78,7 @@ int testingHashTableWithBenchmark()
 	static constexpr auto UNIFORM_DIST_RND_MAX = 500000;
 	static constexpr auto RND_STIRNGS_LEN = 5;
 	static constexpr auto HASH_TABLE_CAP = 15;
+	static constexpr auto LOOKUP_ROUNDS = 1000;
 
 	try
 	{
@@ -86,6 +109,7 @@ int testingHashTableWithBenchmark()
 		}
 
 		// Popluating Ht with benchmarking for put
+		std::cout << "[HashTable] put: ";
 		{
 			Timer timer;
 			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
@@ -94,6 +118,66 @@ int testingHashTableWithBenchmark()
 			}
 		}
 
+		// Same keys in the tag-probed SwissHashTable
+		SwissHashTable<std::string, size_t> swissHt(HASH_TABLE_CAP);
+		std::cout << "[SwissHashTable] insert_or_assign: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				swissHt.insert_or_assign(rndStrs.at(i), rndVals.at(i));
+			}
+		}
+
+		// And in the StringHashTable, which keeps these short keys inline in its slots
+		StringHashTable<size_t> stringHt(HASH_TABLE_CAP);
+		std::cout << "[StringHashTable] insert_or_assign: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				stringHt.insert_or_assign(rndStrs.at(i), rndVals.at(i));
+			}
+		}
+
+		size_t checksum = 0;
+		std::cout << "[HashTable] get: ";
+		{
+			Timer timer;
+			for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+			{
+				for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+				{
+					checksum += ht.get(rndStrs[i]).getSize();
+				}
+			}
+		}
+
+		std::cout << "[SwissHashTable] find: ";
+		{
+			Timer timer;
+			for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+			{
+				for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+				{
+					checksum += *swissHt.find(rndStrs[i]);
+				}
+			}
+		}
+
+		std::cout << "[StringHashTable] find: ";
+		{
+			Timer timer;
+			for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+			{
+				for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+				{
+					checksum += *stringHt.find(rndStrs[i]);
+				}
+			}
+		}
+		std::cout << "Checksum: " << checksum << ", SwissHashTable entries: " << swissHt.size() << " in " << swissHt.getCapacity() << " slots\n";
+
 		// Some Informational print outs for debugging
 		ht.get(rndStrs[0]).printNodes();
 		ht.printBinsInfo();
@@ -106,6 +190,2089 @@ int testingHashTableWithBenchmark()
 	}
 }
 
+int testingFlatHashTableWithBenchmark()
+{
+	// Constants
+	static constexpr auto LOOP_ITERATIONS_POPULATION = 500000;
+	static constexpr auto UNIFORM_DIST_RND_MIN = 0;
+	static constexpr auto UNIFORM_DIST_RND_MAX = 5000000;
+	static constexpr auto LEGACY_HASH_TABLE_CAP = 1 << 16;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		std::uniform_int_distribution<std::size_t> distribution(UNIFORM_DIST_RND_MIN, UNIFORM_DIST_RND_MAX);
+		auto roll_dice = std::bind(distribution, generator);
+
+		// Keys are unique so that erasing one key must never affect another one
+		std::vector<size_t> rndKeys;
+		rndKeys.reserve(LOOP_ITERATIONS_POPULATION);
+		for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+		{
+			rndKeys.emplace_back(i * UNIFORM_DIST_RND_MAX + roll_dice());
+		}
+		std::shuffle(rndKeys.begin(), rndKeys.end(), generator);
+
+		HashTable<size_t, size_t> legacyHt(LEGACY_HASH_TABLE_CAP);
+		FlatHashTable<size_t, size_t> flatHt;
+
+		std::cout << "[Legacy chaining] put: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				legacyHt.put(rndKeys[i], i);
+			}
+		}
+
+		std::cout << "[Flat open-addressing] insert_or_assign: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				flatHt.insert_or_assign(rndKeys[i], i);
+			}
+		}
+
+		size_t checksum = 0;
+		std::cout << "[Legacy chaining] get: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				checksum += legacyHt.get(rndKeys[i]).getSize();
+			}
+		}
+
+		std::cout << "[Flat open-addressing] find: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				checksum += *flatHt.find(rndKeys[i]);
+			}
+		}
+
+		// Erase every other key and make sure the rest is still reachable
+		for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; i += 2)
+		{
+			flatHt.erase(rndKeys[i]);
+		}
+		for (size_t i = 1; i < LOOP_ITERATIONS_POPULATION; i += 2)
+		{
+			if (!flatHt.contains(rndKeys[i]))
+			{
+				std::cout << "Key " << rndKeys[i] << " got lost after erasing its neighbours!" << std::endl;
+				return -1;
+			}
+		}
+
+		std::cout << "Entries: " << flatHt.size() << ", capacity: " << flatHt.getCapacity() << ", load factor: " << flatHt.load_factor() << ", checksum: " << checksum << std::endl;
+
+		// Worst single insert while growing from the minimal capacity, with one-shot and incremental rehashing
+		for (const bool incremental : {false, true})
+		{
+			FlatHashTable<size_t, size_t> growingHt;
+			growingHt.set_incremental_rehash(incremental);
+
+			std::chrono::nanoseconds worstInsert(0);
+			for (size_t i = 0; i < LOOP_ITERATIONS_POPULATION; ++i)
+			{
+				const auto start = std::chrono::high_resolution_clock::now();
+				growingHt.insert(rndKeys[i], i);
+				const auto took = std::chrono::high_resolution_clock::now() - start;
+				worstInsert = std::max(worstInsert, std::chrono::duration_cast<std::chrono::nanoseconds>(took));
+			}
+
+			std::cout << (incremental ? "[Incremental rehash]" : "[One-shot rehash]")
+					  << " worst insert: " << worstInsert.count() << "ns, capacity: " << growingHt.getCapacity() << std::endl;
+		}
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingFlatHashTableBatchWithBenchmark()
+{
+	// Constants
+	static constexpr size_t TABLE_ENTRIES = 1 << 23; // ~400MB of slots, far beyond the last level cache
+	static constexpr size_t LOOKUPS = 1 << 22;
+	static constexpr size_t BATCH_SIZES[] = {32, 256};
+
+	try
+	{
+		std::mt19937_64 generator(42);
+		std::vector<size_t> keys(TABLE_ENTRIES);
+		for (auto &key : keys)
+		{
+			key = generator();
+		}
+
+		FlatHashTable<size_t, size_t> scalarHt;
+		std::cout << "[Scalar] insert_or_assign: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < TABLE_ENTRIES; ++i)
+			{
+				scalarHt.insert_or_assign(keys[i], i);
+			}
+		}
+
+		FlatHashTable<size_t, size_t> batchHt;
+		std::cout << "[Batch] put_batch: ";
+		{
+			Timer timer;
+			batchHt.put_batch(keys.data(), keys.data(), TABLE_ENTRIES);
+		}
+
+		// Lookup keys in random order, half of them absent
+		std::vector<size_t> lookupKeys(LOOKUPS);
+		for (size_t i = 0; i < LOOKUPS; ++i)
+		{
+			lookupKeys[i] = i % 2 == 0 ? keys[generator() % TABLE_ENTRIES] : generator();
+		}
+
+		size_t scalarHits = 0;
+		std::cout << "[Scalar] find: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < LOOKUPS; ++i)
+			{
+				scalarHits += scalarHt.find(lookupKeys[i]) != nullptr ? 1 : 0;
+			}
+		}
+
+		for (const size_t batchSize : BATCH_SIZES)
+		{
+			std::vector<size_t *> results(batchSize);
+			size_t batchHits = 0;
+			std::cout << "[Batch " << batchSize << "] get_batch: ";
+			{
+				Timer timer;
+				for (size_t base = 0; base < LOOKUPS; base += batchSize)
+				{
+					batchHits += batchHt.get_batch(&lookupKeys[base], std::min(batchSize, LOOKUPS - base), results.data());
+				}
+			}
+
+			if (batchHits != scalarHits)
+			{
+				std::cout << "Batch hits (" << batchHits << ") differ from scalar hits (" << scalarHits << ")!" << std::endl;
+				return -1;
+			}
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+// Runs a mixed put/get workload on `threadCount` threads and prints the throughput
+template <typename PutFunc, typename GetFunc>
+void benchmarkMixedWorkload(
+	const char *name,
+	const size_t threadCount,
+	const size_t opsPerThread,
+	const size_t putEveryNthOp,
+	const size_t keySpace,
+	PutFunc &&put,
+	GetFunc &&get)
+{
+	std::vector<std::thread> workers;
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (size_t t = 0; t < threadCount; ++t)
+	{
+		workers.emplace_back([&, t]() {
+			std::mt19937_64 generator(t + 1);
+			size_t hits = 0;
+			for (size_t i = 0; i < opsPerThread; ++i)
+			{
+				const size_t key = generator() % keySpace;
+				if (i % putEveryNthOp == 0)
+				{
+					put(key, i);
+				}
+				else
+				{
+					hits += get(key) ? 1 : 0;
+				}
+			}
+			volatile size_t sink = hits;
+			(void)sink;
+		});
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+	const std::chrono::duration<double> took = std::chrono::high_resolution_clock::now() - start;
+	std::cout << name << " threads: " << threadCount << "\t"
+			  << static_cast<size_t>(threadCount * opsPerThread / took.count()) << " ops/s" << std::endl;
+}
+
+int testingConcurrentHashTableWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_SPACE = 1 << 20;
+	static constexpr size_t OPS_PER_THREAD = 1000000;
+	static constexpr size_t PUT_EVERY_NTH_OP = 10; // 90% get, 10% put
+
+	try
+	{
+		const size_t maxThreads = std::max<size_t>(4, std::thread::hardware_concurrency());
+
+		for (size_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+		{
+			// What callers do today: one table behind one mutex
+			FlatHashTable<size_t, size_t> lockedHt;
+			std::mutex tableMutex;
+			benchmarkMixedWorkload(
+				"[Single mutex FlatHashTable]", threadCount, OPS_PER_THREAD, PUT_EVERY_NTH_OP, KEY_SPACE,
+				[&](const size_t key, const size_t value) { std::lock_guard<std::mutex> lock(tableMutex); lockedHt.insert_or_assign(key, value); },
+				[&](const size_t key) { std::lock_guard<std::mutex> lock(tableMutex); return lockedHt.contains(key); });
+
+			ConcurrentHashTable<size_t, size_t> concurrentHt;
+			benchmarkMixedWorkload(
+				"[Lock-striped ConcurrentHashTable]", threadCount, OPS_PER_THREAD, PUT_EVERY_NTH_OP, KEY_SPACE,
+				[&](const size_t key, const size_t value) { concurrentHt.put(key, value); },
+				[&](const size_t key) { return concurrentHt.contains(key); });
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingLockFreeHashTableWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_SPACE = 1 << 20;
+	static constexpr size_t OPS_PER_THREAD = 1000000;
+	static constexpr size_t PUT_EVERY_NTH_OP = 100; // 99% get, 1% put
+
+	try
+	{
+		const size_t maxThreads = std::max<size_t>(4, std::thread::hardware_concurrency());
+
+		for (size_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+		{
+			ConcurrentHashTable<size_t, size_t> concurrentHt;
+			benchmarkMixedWorkload(
+				"[Lock-striped ConcurrentHashTable]", threadCount, OPS_PER_THREAD, PUT_EVERY_NTH_OP, KEY_SPACE,
+				[&](const size_t key, const size_t value) { concurrentHt.put(key, value); },
+				[&](const size_t key) { return concurrentHt.contains(key); });
+
+			LockFreeHashTable<size_t, size_t> lockFreeHt;
+			benchmarkMixedWorkload(
+				"[Split-ordered LockFreeHashTable]", threadCount, OPS_PER_THREAD, PUT_EVERY_NTH_OP, KEY_SPACE,
+				[&](const size_t key, const size_t value) { lockFreeHt.insert(key, value); },
+				[&](const size_t key) { return lockFreeHt.contains(key); });
+		}
+
+		// Make sure erased keys are really gone and the rest is still there
+		LockFreeHashTable<size_t, size_t> lockFreeHt;
+		for (size_t i = 0; i < KEY_SPACE; ++i)
+		{
+			lockFreeHt.insert(i, i);
+		}
+		for (size_t i = 0; i < KEY_SPACE; i += 2)
+		{
+			lockFreeHt.erase(i);
+		}
+		for (size_t i = 0; i < KEY_SPACE; ++i)
+		{
+			if (lockFreeHt.contains(i) != (i % 2 == 1))
+			{
+				std::cout << "Key " << i << " has the wrong state after erasing!" << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "Entries: " << lockFreeHt.size() << ", buckets: " << lockFreeHt.getCapacity() << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingHashPoliciesWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 1 << 16;
+	static constexpr size_t KEY_STRIDE = 64; // e.g. ids handed out in blocks, or aligned addresses
+	static constexpr size_t LEGACY_HASH_TABLE_CAP = 1 << 12;
+	static constexpr size_t STRING_COUNT = 1000000;
+	static constexpr size_t STRING_LEN = 24;
+
+	try
+	{
+		// Strided integer keys: std::hash maps them to themselves, so std::hash % capacity would only
+		// use every 64th bin. The bin reducer scrambles the hash first, so even std::hash spreads here.
+		HashTable<size_t, size_t, std::hash<size_t>> identityHt(LEGACY_HASH_TABLE_CAP);
+		HashTable<size_t, size_t> fastHt(LEGACY_HASH_TABLE_CAP);
+		FlatHashTable<size_t, size_t> flatHt;
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			identityHt.put(i * KEY_STRIDE, i);
+			fastHt.put(i * KEY_STRIDE, i);
+			flatHt.insert(i * KEY_STRIDE, i);
+		}
+
+		std::cout << "[HashTable, std::hash] strided keys:\n";
+		identityHt.getDistributionStats().print("chain length");
+		std::cout << "[HashTable, FastHash] strided keys:\n";
+		fastHt.getDistributionStats().print("chain length");
+		std::cout << "[FlatHashTable, FastHash] strided keys:\n";
+		flatHt.getDistributionStats().print("probe length");
+
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		std::uniform_int_distribution<int> distribution('a', 'z');
+		std::vector<std::string> rndStrs(STRING_COUNT);
+		for (auto& str : rndStrs)
+		{
+			str.resize(STRING_LEN);
+			for (auto& c : str)
+			{
+				c = static_cast<char>(distribution(generator));
+			}
+		}
+
+		size_t checksum = 0;
+		std::cout << "[std::hash] " << STRING_COUNT << " strings: ";
+		{
+			Timer timer;
+			for (const auto& str : rndStrs)
+			{
+				checksum += std::hash<std::string>{}(str);
+			}
+		}
+		std::cout << "[FastHash] " << STRING_COUNT << " strings: ";
+		{
+			Timer timer;
+			for (const auto& str : rndStrs)
+			{
+				checksum += FastHash<std::string>{}(str);
+			}
+		}
+		std::cout << "Checksum: " << checksum << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingTransparentLookupWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 100000;
+	static constexpr size_t KEY_LEN = 32; // longer than the small string buffer, so a std::string allocates
+	static constexpr size_t LOOKUP_ROUNDS = 20;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		std::uniform_int_distribution<int> distribution('a', 'z');
+
+		// All keys live in one buffer, callers only hold std::string_views into it
+		std::string buffer(KEY_COUNT * KEY_LEN, ' ');
+		for (auto& c : buffer)
+		{
+			c = static_cast<char>(distribution(generator));
+		}
+		std::vector<std::string_view> views;
+		views.reserve(KEY_COUNT);
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			views.emplace_back(buffer.data() + i * KEY_LEN, KEY_LEN);
+		}
+
+		FlatHashTable<std::string, size_t> flatHt;
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			flatHt.insert(std::string(views[i]), i);
+		}
+
+		size_t checksum = 0;
+		std::cout << "[FlatHashTable] find(std::string(view)): ";
+		{
+			Timer timer;
+			for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+			{
+				for (const auto& view : views)
+				{
+					checksum += *flatHt.find(std::string(view));
+				}
+			}
+		}
+
+		std::cout << "[FlatHashTable] find(view): ";
+		{
+			Timer timer;
+			for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+			{
+				for (const auto& view : views)
+				{
+					checksum += *flatHt.find(view);
+				}
+			}
+		}
+
+		// The trees use the transparent std::less<> by default
+		AVLTree<std::string> avl;
+		BinarySearchTree<std::string> bst;
+		for (size_t i = 0; i < 100; ++i)
+		{
+			avl.insertNode(std::string(views[i]));
+			bst.insertNode(std::string(views[i]));
+		}
+		for (size_t i = 0; i < 100; ++i)
+		{
+			if (avl.searchNode(views[i]) == nullptr || bst.DFS(views[i]) == nullptr)
+			{
+				std::cout << "Key " << views[i] << " not found in the trees!" << std::endl;
+				return -1;
+			}
+		}
+		checksum += flatHt.contains("not a key") ? 1 : 0;
+		std::cout << "Checksum: " << checksum << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingStringHashTableWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 200000;
+	static constexpr size_t KEY_LENGTHS[] = { 5, 20, 40 }; // inline in both, inline only in StringHashTable, arena
+	static constexpr size_t LOOKUP_ROUNDS = 10;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		std::uniform_int_distribution<int> distribution('a', 'z');
+
+		for (const size_t keyLength : KEY_LENGTHS)
+		{
+			// Unique keys: a random prefix followed by the index
+			std::vector<std::string> keys;
+			keys.reserve(KEY_COUNT);
+			for (size_t i = 0; i < KEY_COUNT; ++i)
+			{
+				std::string key = std::to_string(i);
+				while (key.size() < keyLength)
+				{
+					key.insert(key.begin(), static_cast<char>(distribution(generator)));
+				}
+				keys.emplace_back(std::move(key));
+			}
+			std::cout << "Key length " << keyLength << ":\n";
+
+			size_t checksum = 0;
+			{
+				FlatHashTable<std::string, size_t> flatHt;
+				std::cout << "[FlatHashTable<std::string>] insert: ";
+				{
+					Timer timer;
+					for (size_t i = 0; i < KEY_COUNT; ++i)
+					{
+						flatHt.insert(keys[i], i);
+					}
+				}
+				std::cout << "[FlatHashTable<std::string>] find: ";
+				{
+					Timer timer;
+					for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+					{
+						for (const auto& key : keys)
+						{
+							checksum += *flatHt.find(key);
+						}
+					}
+				}
+			}
+
+			{
+				StringHashTable<size_t> stringHt;
+				std::cout << "[StringHashTable] insert: ";
+				{
+					Timer timer;
+					for (size_t i = 0; i < KEY_COUNT; ++i)
+					{
+						stringHt.insert(keys[i], i);
+					}
+				}
+				std::cout << "[StringHashTable] find: ";
+				{
+					Timer timer;
+					for (size_t round = 0; round < LOOKUP_ROUNDS; ++round)
+					{
+						for (const auto& key : keys)
+						{
+							checksum += *stringHt.find(key);
+						}
+					}
+				}
+				std::cout << "Checksum: " << checksum << ", arena bytes: " << stringHt.getArenaSize() << std::endl;
+			}
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+template <template <typename> class Policy>
+void benchmarkCachePolicy(const std::string& name, const std::vector<size_t>& requests, const size_t maxEntries)
+{
+	BoundedCache<size_t, std::string, Policy> cache(maxEntries);
+	std::cout << name << " " << requests.size() << " requests: ";
+	{
+		Timer timer;
+		for (const size_t key : requests)
+		{
+			if (cache.get(key) == nullptr)
+			{
+				// miss: "load" the value from the slow store
+				cache.put(key, std::to_string(key));
+			}
+		}
+	}
+	cache.printStats();
+}
+
+int testingBoundedCacheWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_SPACE = 1000000;
+	static constexpr size_t REQUEST_COUNT = 2000000;
+	static constexpr size_t CACHE_ENTRIES = 10000;
+	static constexpr size_t SCAN_PERIOD = 100000; // every SCAN_PERIOD requests starts with a scan
+	static constexpr size_t SCAN_LENGTH = 20000;  // of SCAN_LENGTH one-off keys
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		// Skewed popularity: a few keys get most requests (roughly Zipf like)
+		std::exponential_distribution<double> popularity(1.0 / CACHE_ENTRIES);
+
+		std::vector<size_t> requests;
+		requests.reserve(REQUEST_COUNT);
+		size_t scanKey = KEY_SPACE;
+		for (size_t i = 0; i < REQUEST_COUNT; ++i)
+		{
+			if (i % SCAN_PERIOD < SCAN_LENGTH)
+			{
+				requests.push_back(scanKey++);
+			}
+			else
+			{
+				requests.push_back(static_cast<size_t>(popularity(generator)) % KEY_SPACE);
+			}
+		}
+
+		benchmarkCachePolicy<LruPolicy>("[BoundedCache LRU]", requests, CACHE_ENTRIES);
+		benchmarkCachePolicy<ClockPolicy>("[BoundedCache CLOCK]", requests, CACHE_ENTRIES);
+		benchmarkCachePolicy<S3FifoPolicy>("[BoundedCache S3-FIFO]", requests, CACHE_ENTRIES);
+
+		// The byte bound alone also limits the cache
+		BoundedCache<size_t, std::string> byteBoundCache(KEY_SPACE, 1 << 20);
+		for (size_t i = 0; i < KEY_SPACE; ++i)
+		{
+			byteBoundCache.put(i, std::string(100, 'x'));
+		}
+		std::cout << "[BoundedCache 1MB] ";
+		byteBoundCache.printStats();
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingMappedHashTableWithBenchmark()
+{
+	// Constants
+	static constexpr size_t ENTRY_COUNT = 2000000;
+	static constexpr size_t LOOKUP_COUNT = 100000;
+	static constexpr const char* FIXED_PATH = "flat_snapshot.bin";
+	static constexpr const char* STRING_PATH = "string_snapshot.bin";
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937_64 generator(rd());
+
+		FlatHashTable<uint64_t, uint64_t> flatHt;
+		std::vector<uint64_t> keys;
+		keys.reserve(ENTRY_COUNT);
+		for (size_t i = 0; i < ENTRY_COUNT; ++i)
+		{
+			keys.push_back(generator());
+			flatHt.insert(keys.back(), i);
+		}
+
+		std::cout << "[FlatHashTable] save " << ENTRY_COUNT << " entries: ";
+		{
+			Timer timer;
+			flatHt.save(FIXED_PATH);
+		}
+
+		// Loading the snapshot the classic way means reinserting every entry
+		std::cout << "[FlatHashTable] rebuild " << ENTRY_COUNT << " entries: ";
+		{
+			Timer timer;
+			FlatHashTable<uint64_t, uint64_t> rebuilt;
+			for (size_t i = 0; i < ENTRY_COUNT; ++i)
+			{
+				rebuilt.insert(keys[i], i);
+			}
+		}
+
+		std::shuffle(keys.begin(), keys.end(), generator);
+		uint64_t checksum = 0;
+		std::cout << "[MappedHashTable] map + " << LOOKUP_COUNT << " lookups: ";
+		{
+			Timer timer;
+			MappedHashTable<uint64_t, uint64_t> mapped(FIXED_PATH);
+			for (size_t i = 0; i < LOOKUP_COUNT; ++i)
+			{
+				const uint64_t* value = mapped.find(keys[i]);
+				if (value == nullptr || *value != *flatHt.find(keys[i]))
+				{
+					std::cout << "Key " << keys[i] << " not found in the snapshot!" << std::endl;
+					return -1;
+				}
+				checksum += *value;
+			}
+		}
+
+		StringHashTable<uint32_t> strHt;
+		for (uint32_t i = 0; i < LOOKUP_COUNT; ++i)
+		{
+			strHt.insert("snapshot/key/" + std::to_string(i), i);
+		}
+		strHt.save(STRING_PATH);
+		MappedHashTable<std::string, uint32_t> mappedStrings(STRING_PATH);
+		for (uint32_t i = 0; i < LOOKUP_COUNT; ++i)
+		{
+			const uint32_t* value = mappedStrings.find("snapshot/key/" + std::to_string(i));
+			if (value == nullptr || *value != i)
+			{
+				std::cout << "String key " << i << " not found in the snapshot!" << std::endl;
+				return -1;
+			}
+		}
+		std::cout << "[MappedHashTable<std::string>] " << mappedStrings.size() << " entries in " << mappedStrings.getCapacity() << " slots" << std::endl;
+		std::cout << "Checksum: " << checksum << std::endl;
+
+		std::remove(FIXED_PATH);
+		std::remove(STRING_PATH);
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingBlockedBloomFilterWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 200000;
+	static constexpr size_t QUERY_COUNT = 2000000;
+	static constexpr size_t MISS_PERCENTAGE = 90;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937_64 generator(rd());
+
+		// Even keys are stored, odd keys are the misses
+		std::vector<uint64_t> keys;
+		keys.reserve(KEY_COUNT);
+		for (uint64_t i = 0; i < KEY_COUNT; ++i)
+		{
+			keys.push_back(i * 2);
+		}
+		std::shuffle(keys.begin(), keys.end(), generator);
+
+		AVLTree<uint64_t> avl;
+		FlatHashTable<uint64_t, uint64_t> flatHt;
+		BlockedBloomFilter<uint64_t> avlFilter(KEY_COUNT, 0.01);
+		BlockedBloomFilter<uint64_t> flatFilter(KEY_COUNT, 0.01);
+		for (const uint64_t key : keys)
+		{
+			avl.insertNode(key);
+			avlFilter.insert(key);
+			flatHt.insert(key, key);
+			flatFilter.insert(key);
+		}
+
+		std::uniform_int_distribution<uint64_t> keyDistribution(0, KEY_COUNT - 1);
+		std::uniform_int_distribution<size_t> percentage(0, 99);
+		std::vector<uint64_t> queries;
+		queries.reserve(QUERY_COUNT);
+		for (size_t i = 0; i < QUERY_COUNT; ++i)
+		{
+			const uint64_t key = keyDistribution(generator) * 2;
+			queries.push_back(percentage(generator) < MISS_PERCENTAGE ? key + 1 : key);
+		}
+
+		size_t found = 0;
+		std::cout << "[AVLTree] " << QUERY_COUNT << " lookups, " << MISS_PERCENTAGE << "% misses: ";
+		{
+			Timer timer;
+			for (const uint64_t key : queries)
+			{
+				found += avl.searchNode(key) != nullptr;
+			}
+		}
+		std::cout << "[BlockedBloomFilter + AVLTree] " << QUERY_COUNT << " lookups: ";
+		{
+			Timer timer;
+			for (const uint64_t key : queries)
+			{
+				found += avlFilter.find(key, [&avl](const uint64_t k) { return avl.searchNode(k); }) != nullptr;
+			}
+		}
+		avlFilter.printStats();
+
+		std::cout << "[FlatHashTable] " << QUERY_COUNT << " lookups: ";
+		{
+			Timer timer;
+			for (const uint64_t key : queries)
+			{
+				found += flatHt.find(key) != nullptr;
+			}
+		}
+		std::cout << "[BlockedBloomFilter + FlatHashTable] " << QUERY_COUNT << " lookups: ";
+		{
+			Timer timer;
+			for (const uint64_t key : queries)
+			{
+				found += flatFilter.find(key, [&flatHt](const uint64_t k) { return flatHt.find(k); }) != nullptr;
+			}
+		}
+		flatFilter.printStats();
+		std::cout << "Found: " << found << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingEraseIfWithBenchmark()
+{
+	// Constants
+	static constexpr size_t ENTRY_COUNT = 1000000;
+	static constexpr uint32_t MAX_TTL = 100;
+	static constexpr uint32_t NOW = 30; // entries with an expiry time before NOW are dropped
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937_64 generator(rd());
+		std::uniform_int_distribution<uint32_t> ttl(0, MAX_TTL - 1);
+
+		// key -> expiry time
+		FlatHashTable<uint64_t, uint32_t> eraseOneByOne;
+		FlatHashTable<uint64_t, uint32_t> eraseInOneSweep;
+		ConcurrentHashTable<uint64_t, uint32_t> concurrentHt;
+		SwissHashTable<uint64_t, uint32_t> swissHt;
+		for (size_t i = 0; i < ENTRY_COUNT; ++i)
+		{
+			const uint64_t key = generator();
+			const uint32_t expiry = ttl(generator);
+			eraseOneByOne.insert(key, expiry);
+			eraseInOneSweep.insert(key, expiry);
+			concurrentHt.put(key, expiry);
+			swissHt.insert(key, expiry);
+		}
+
+		std::cout << "[FlatHashTable] collect + erase expired keys one by one: ";
+		{
+			Timer timer;
+			std::vector<uint64_t> expired;
+			eraseOneByOne.forEach([&expired](const uint64_t key, const uint32_t expiry)
+				{
+					if (expiry < NOW)
+					{
+						expired.push_back(key);
+					}
+				});
+			for (const uint64_t key : expired)
+			{
+				eraseOneByOne.erase(key);
+			}
+		}
+
+		size_t removed = 0;
+		std::cout << "[FlatHashTable] erase_if expired: ";
+		{
+			Timer timer;
+			removed = eraseInOneSweep.erase_if([](const uint64_t, const uint32_t expiry)
+				{
+					return expiry < NOW;
+				});
+		}
+		std::cout << "Removed: " << removed << "\tLeft: " << eraseInOneSweep.size() << "/" << eraseOneByOne.size() << std::endl;
+
+		std::cout << "[ConcurrentHashTable] erase_if expired: ";
+		{
+			Timer timer;
+			removed = concurrentHt.erase_if([](const uint64_t, const uint32_t expiry)
+				{
+					return expiry < NOW;
+				});
+		}
+		std::cout << "Removed: " << removed << "\tLeft: " << concurrentHt.size() << std::endl;
+
+		std::cout << "[SwissHashTable] erase_if expired: ";
+		{
+			Timer timer;
+			removed = swissHt.erase_if([](const uint64_t, const uint32_t expiry)
+				{
+					return expiry < NOW;
+				});
+		}
+		std::cout << "Removed: " << removed << "\tLeft: " << swissHt.size() << std::endl;
+
+		return eraseInOneSweep.size() == eraseOneByOne.size() && concurrentHt.size() == eraseOneByOne.size()
+			&& swissHt.size() == eraseOneByOne.size() ? 0 : -1;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+// Inserts values into a fresh container and destroys it again, timing both together
+template<typename Container, typename Insert>
+void benchmarkContainerLifetime(const char* name, const std::vector<int>& values, Insert insert)
+{
+	std::cout << name << " insert " << values.size() << " + destroy: ";
+	Timer timer;
+	Container container;
+	for (const int value : values)
+	{
+		insert(container, value);
+	}
+}
+
+int testingPoolAllocatorWithBenchmark()
+{
+	// Constants
+	static constexpr size_t VALUE_COUNT = 1000000;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		std::uniform_int_distribution<int> distribution(0, std::numeric_limits<int>::max());
+		std::vector<int> values;
+		values.reserve(VALUE_COUNT);
+		for (size_t i = 0; i < VALUE_COUNT; ++i)
+		{
+			values.push_back(distribution(generator));
+		}
+
+		const auto listInsert = [](auto& list, const int value) { list.insertAtHead(value); };
+		const auto treeInsert = [](auto& tree, const int value) { tree.insertNode(value); };
+
+		benchmarkContainerLifetime<LinkedList<int>>("[LinkedList std::allocator]", values, listInsert);
+		benchmarkContainerLifetime<LinkedList<int, PoolAllocator<int>>>("[LinkedList PoolAllocator]", values, listInsert);
+		benchmarkContainerLifetime<AVLTree<int>>("[AVLTree std::allocator]", values, treeInsert);
+		benchmarkContainerLifetime<AVLTree<int, std::less<>, PoolAllocator<int>>>("[AVLTree PoolAllocator]", values, treeInsert);
+		benchmarkContainerLifetime<BinarySearchTree<int>>("[BinarySearchTree std::allocator]", values, treeInsert);
+		benchmarkContainerLifetime<BinarySearchTree<int, std::less<>, PoolAllocator<int>>>("[BinarySearchTree PoolAllocator]", values, treeInsert);
+
+		std::cout << "[HashTable std::allocator] put " << VALUE_COUNT << " + destroy: ";
+		{
+			Timer timer;
+			HashTable<int, int> ht(VALUE_COUNT / 4);
+			for (const int value : values)
+			{
+				ht.put(value, value);
+			}
+		}
+		std::cout << "[HashTable PoolAllocator] put " << VALUE_COUNT << " + destroy: ";
+		{
+			Timer timer;
+			HashTable<int, int, FastHash<int>, PoolAllocator<int>> ht(VALUE_COUNT / 4);
+			for (const int value : values)
+			{
+				ht.put(value, value);
+			}
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingUnrolledLinkedListWithBenchmark()
+{
+	// Constants
+	static constexpr size_t VALUE_COUNT = 4000000;
+	static constexpr int VALUE_RANGE = 1000;
+	static constexpr int MISSING_VALUE = -1;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+		std::uniform_int_distribution<int> distribution(0, VALUE_RANGE - 1);
+
+		LinkedList<int> list;
+		UnrolledLinkedList<int> unrolledList;
+		for (size_t i = 0; i < VALUE_COUNT; ++i)
+		{
+			const int value = distribution(generator);
+			list.insertAtHead(value);
+			unrolledList.insertAtHead(value);
+		}
+
+		bool found = false;
+		std::cout << "[LinkedList] full scan of " << VALUE_COUNT << " values: ";
+		{
+			Timer timer;
+			found |= list.getNode(MISSING_VALUE) != nullptr;
+		}
+		std::cout << "[UnrolledLinkedList] full scan of " << VALUE_COUNT << " values: ";
+		{
+			Timer timer;
+			found |= unrolledList.contains(MISSING_VALUE);
+		}
+
+		std::cout << "[LinkedList] deleteNodesGivenData: ";
+		{
+			Timer timer;
+			list.deleteNodesGivenData(VALUE_RANGE / 2);
+		}
+		std::cout << "[UnrolledLinkedList] deleteNodesGivenData: ";
+		size_t deleted = 0;
+		{
+			Timer timer;
+			deleted = unrolledList.deleteNodesGivenData(VALUE_RANGE / 2);
+		}
+
+		std::cout << "Found: " << found << "\tDeleted: " << deleted << "\tValues per block: " << UnrolledLinkedList<int>::ELEMENTS_PER_BLOCK << "\n";
+		std::cout << "Memory: LinkedList >= " << unrolledList.getSize() * sizeof(Node<int>) << " bytes (without malloc overhead)"
+			<< "\tUnrolledLinkedList " << unrolledList.getMemoryUsage() << " bytes" << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingLinkedListQueueWithBenchmark()
+{
+	// Constants
+	static constexpr int QUEUE_ITEMS = 2000000;
+	static constexpr int BATCH_SIZE = 1000;
+
+	try
+	{
+		long long checksum = 0;
+		std::cout << "[LinkedList] insertAtTail + popFront of " << QUEUE_ITEMS << " values: ";
+		{
+			Timer timer;
+			LinkedList<int> queue;
+			for (int i = 0; i < QUEUE_ITEMS; ++i)
+			{
+				queue.insertAtTail(i);
+			}
+			int value = 0;
+			while (queue.popFront(value))
+			{
+				checksum += value;
+			}
+		}
+		std::cout << "[std::queue] push + pop of " << QUEUE_ITEMS << " values: ";
+		{
+			Timer timer;
+			std::queue<int> queue;
+			for (int i = 0; i < QUEUE_ITEMS; ++i)
+			{
+				queue.push(i);
+			}
+			while (!queue.empty())
+			{
+				checksum -= queue.front();
+				queue.pop();
+			}
+		}
+
+		// producer fills batches, the pipeline takes each one over with a single splice
+		size_t sizeAfterSplices = 0;
+		std::cout << "[LinkedList] " << QUEUE_ITEMS / BATCH_SIZE << " batches of " << BATCH_SIZE << " spliced, then drained: ";
+		{
+			Timer timer;
+			LinkedList<int> pipeline;
+			for (int batchStart = 0; batchStart < QUEUE_ITEMS; batchStart += BATCH_SIZE)
+			{
+				LinkedList<int> batch;
+				for (int i = batchStart; i < batchStart + BATCH_SIZE; ++i)
+				{
+					batch.insertAtTail(i);
+				}
+				pipeline.splice(batch);
+			}
+			sizeAfterSplices = pipeline.getSize();
+
+			int value = 0;
+			int expected = 0;
+			while (pipeline.popFront(value))
+			{
+				if (value != expected++)
+				{
+					throw std::runtime_error("pipeline lost the FIFO order");
+				}
+			}
+		}
+
+		LinkedList<int, PoolAllocator<int>> firstPooled;
+		LinkedList<int, PoolAllocator<int>> secondPooled;
+		secondPooled.insertAtTail(1);
+		bool spliceRejected = false;
+		try
+		{
+			firstPooled.splice(secondPooled);
+		}
+		catch (const std::invalid_argument&)
+		{
+			spliceRejected = true;
+		}
+
+		std::cout << "Checksum: " << checksum << "\tSize after splices: " << sizeAfterSplices
+			<< "\tSplice across pools rejected: " << spliceRejected << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingLinkedListIteratorsWithBenchmark()
+{
+	// Constants
+	static constexpr size_t LIST_SIZE = 32;
+	static constexpr size_t LOOKUPS = 1000000;
+	static constexpr size_t STRING_LENGTH = 64;
+
+	try
+	{
+		std::random_device rd;
+		std::mt19937 generator(rd());
+
+		LinkedList<std::string> list;
+		std::vector<std::string> keys;
+		for (size_t i = 0; i < LIST_SIZE; ++i)
+		{
+			keys.push_back(randomStrGen(STRING_LENGTH, generator()) + std::to_string(i));
+			list.insertAtTail(keys.back());
+		}
+		std::uniform_int_distribution<size_t> keyDistribution(0, LIST_SIZE - 1);
+		std::vector<size_t> lookupOrder(LOOKUPS);
+		for (size_t& idx : lookupOrder)
+		{
+			idx = keyDistribution(generator);
+		}
+
+		size_t totalLength = 0;
+		std::cout << "[LinkedList] copying lookup (heap copy of the node per hit): ";
+		{
+			Timer timer;
+			for (const size_t idx : lookupOrder)
+			{
+				const auto copy = std::make_unique<Node<std::string>>(*list.getNode(keys[idx]));
+				totalLength += copy->data.size();
+			}
+		}
+		std::cout << "[LinkedList] find (iterator into the list): ";
+		{
+			Timer timer;
+			for (const size_t idx : lookupOrder)
+			{
+				const auto it = list.find(keys[idx]);
+				totalLength -= it->size();
+			}
+		}
+
+		// the list works with range-for and <algorithm>
+		size_t characters = 0;
+		for (const std::string& value : list)
+		{
+			characters += value.size();
+		}
+		const auto longest = std::max_element(list.cbegin(), list.cend(),
+			[](const std::string& lhs, const std::string& rhs) { return lhs.size() < rhs.size(); });
+		const auto startingWithA = std::count_if(list.begin(), list.end(), [](const std::string& value) { return value.front() == 'a'; });
+		std::for_each(list.begin(), list.end(), [](std::string& value) { value.front() = 'x'; });
+		const bool allRewritten = std::all_of(list.cbegin(), list.cend(), [](const std::string& value) { return value.front() == 'x'; });
+
+		std::cout << "Length difference: " << totalLength << "\tCharacters: " << characters << "\tLongest: " << longest->size()
+			<< "\tStarting with 'a': " << startingWithA << "\tAll rewritten: " << allRewritten
+			<< "\tMissing key found: " << (list.find("missing") != list.end()) << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+// Moves itemsPerProducer values from every producer to the consumers through push/pop and prints the throughput
+template <typename PushFunc, typename PopFunc>
+void benchmarkProducerConsumer(
+	const char *name,
+	const size_t producerCount,
+	const size_t consumerCount,
+	const size_t itemsPerProducer,
+	PushFunc &&push,
+	PopFunc &&pop)
+{
+	const size_t totalItems = producerCount * itemsPerProducer;
+	std::atomic<size_t> consumed(0);
+	std::atomic<size_t> checksum(0);
+	std::vector<std::thread> workers;
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (size_t p = 0; p < producerCount; ++p)
+	{
+		workers.emplace_back([&, p]() {
+			for (size_t i = 0; i < itemsPerProducer; ++i)
+			{
+				push(p * itemsPerProducer + i);
+			}
+		});
+	}
+	for (size_t c = 0; c < consumerCount; ++c)
+	{
+		workers.emplace_back([&]() {
+			size_t value = 0;
+			size_t localSum = 0;
+			while (consumed.load(std::memory_order_relaxed) < totalItems)
+			{
+				if (pop(value))
+				{
+					localSum += value;
+					consumed.fetch_add(1, std::memory_order_relaxed);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+			checksum.fetch_add(localSum);
+		});
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+	const std::chrono::duration<double> took = std::chrono::high_resolution_clock::now() - start;
+	const bool complete = checksum.load() == totalItems * (totalItems - 1) / 2;
+	std::cout << name << " producers: " << producerCount << " consumers: " << consumerCount << "\t"
+			  << static_cast<size_t>(totalItems / took.count()) << " items/s" << (complete ? "" : "\tLOST ITEMS!") << std::endl;
+}
+
+int testingLockFreeQueueWithBenchmark()
+{
+	// Constants
+	static constexpr size_t ITEMS_PER_PRODUCER = 200000;
+
+	try
+	{
+		const size_t maxThreads = std::max<size_t>(4, std::thread::hardware_concurrency());
+
+		for (size_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+		{
+			// What callers do today: a LinkedList behind a mutex
+			LinkedList<size_t> lockedQueue;
+			std::mutex queueMutex;
+			benchmarkProducerConsumer(
+				"[Mutex LinkedList queue]", threadCount, threadCount, ITEMS_PER_PRODUCER,
+				[&](const size_t value) { std::lock_guard<std::mutex> lock(queueMutex); lockedQueue.insertAtTail(value); },
+				[&](size_t& value) { std::lock_guard<std::mutex> lock(queueMutex); return lockedQueue.popFront(value); });
+
+			LockFreeQueue<size_t> lockFreeQueue;
+			benchmarkProducerConsumer(
+				"[Michael-Scott LockFreeQueue]", threadCount, threadCount, ITEMS_PER_PRODUCER,
+				[&](const size_t value) { lockFreeQueue.enqueue(value); },
+				[&](size_t& value) { return lockFreeQueue.dequeue(value); });
+
+			LinkedList<size_t> lockedStack;
+			std::mutex stackMutex;
+			benchmarkProducerConsumer(
+				"[Mutex LinkedList stack]", threadCount, threadCount, ITEMS_PER_PRODUCER,
+				[&](const size_t value) { std::lock_guard<std::mutex> lock(stackMutex); lockedStack.insertAtHead(value); },
+				[&](size_t& value) { std::lock_guard<std::mutex> lock(stackMutex); return lockedStack.popFront(value); });
+
+			LockFreeStack<size_t> lockFreeStack;
+			benchmarkProducerConsumer(
+				"[Treiber LockFreeStack]", threadCount, threadCount, ITEMS_PER_PRODUCER,
+				[&](const size_t value) { lockFreeStack.push(value); },
+				[&](size_t& value) { return lockFreeStack.pop(value); });
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+// Nanoseconds on the steady clock, producers stamp every item with it
+uint64_t steadyNanoseconds()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*
+*	Every producer pushes itemsPerProducer timestamps in batches of batchSize through pushN, the
+*	consumers pop them through popN and record how long each item was underway. Prints the
+*	throughput and latency percentiles.
+*	pushN(values, count) / popN(out, maxCount) return how many items they moved, 0 when full / empty.
+*/
+template <typename PushFunc, typename PopFunc>
+void benchmarkHandOffLatency(
+	const char *name,
+	const size_t producerCount,
+	const size_t consumerCount,
+	const size_t itemsPerProducer,
+	const size_t batchSize,
+	PushFunc &&pushN,
+	PopFunc &&popN)
+{
+	const size_t totalItems = producerCount * itemsPerProducer;
+	std::atomic<size_t> consumed(0);
+	std::vector<std::vector<uint64_t>> latencies(consumerCount);
+	std::vector<std::thread> workers;
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (size_t p = 0; p < producerCount; ++p)
+	{
+		workers.emplace_back([&]() {
+			std::vector<uint64_t> batch(batchSize);
+			for (size_t sent = 0; sent < itemsPerProducer;)
+			{
+				const size_t count = std::min(batchSize, itemsPerProducer - sent);
+				const uint64_t now = steadyNanoseconds();
+				std::fill(batch.begin(), batch.begin() + count, now);
+				for (size_t pushed = 0; pushed < count;)
+				{
+					const size_t moved = pushN(batch.data() + pushed, count - pushed);
+					pushed += moved;
+					if (moved == 0)
+					{
+						std::this_thread::yield();
+					}
+				}
+				sent += count;
+			}
+		});
+	}
+	for (size_t c = 0; c < consumerCount; ++c)
+	{
+		workers.emplace_back([&, c]() {
+			std::vector<uint64_t> batch(batchSize);
+			std::vector<uint64_t>& localLatencies = latencies[c];
+			localLatencies.reserve(totalItems / consumerCount);
+			while (consumed.load(std::memory_order_relaxed) < totalItems)
+			{
+				const size_t moved = popN(batch.data(), batchSize);
+				if (moved == 0)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				const uint64_t now = steadyNanoseconds();
+				for (size_t i = 0; i < moved; ++i)
+				{
+					localLatencies.push_back(now - batch[i]);
+				}
+				consumed.fetch_add(moved, std::memory_order_relaxed);
+			}
+		});
+	}
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
+	const std::chrono::duration<double> took = std::chrono::high_resolution_clock::now() - start;
+
+	std::vector<uint64_t> all;
+	for (const auto &localLatencies : latencies)
+	{
+		all.insert(all.end(), localLatencies.begin(), localLatencies.end());
+	}
+	std::sort(all.begin(), all.end());
+	const auto percentile = [&](const double p) { return all.empty() ? 0.0 : all[static_cast<size_t>(p * (all.size() - 1))] / 1000.0; };
+
+	std::cout << name << " " << producerCount << "P/" << consumerCount << "C batch " << batchSize << "\t"
+			  << static_cast<size_t>(totalItems / took.count()) << " items/s\t"
+			  << "p50 " << percentile(0.5) << "us  p99 " << percentile(0.99) << "us  p99.9 " << percentile(0.999) << "us  max " << percentile(1.0) << "us"
+			  << (all.size() == totalItems ? "" : "\tLOST ITEMS!") << std::endl;
+}
+
+int testingRingBufferWithBenchmark()
+{
+	// Constants
+	static constexpr size_t ITEMS_PER_PRODUCER = 1000000;
+	static constexpr size_t RING_CAPACITY = 4096;
+	static constexpr size_t BATCH_SIZE = 32;
+
+	try
+	{
+		{
+			LinkedList<uint64_t> lockedQueue;
+			std::mutex queueMutex;
+			benchmarkHandOffLatency(
+				"[Mutex LinkedList queue]", 1, 1, ITEMS_PER_PRODUCER, 1,
+				[&](const uint64_t* values, size_t) { std::lock_guard<std::mutex> lock(queueMutex); lockedQueue.insertAtTail(*values); return size_t(1); },
+				[&](uint64_t* out, size_t) { std::lock_guard<std::mutex> lock(queueMutex); return size_t(lockedQueue.popFront(*out) ? 1 : 0); });
+		}
+		{
+			LockFreeQueue<uint64_t> lockFreeQueue;
+			benchmarkHandOffLatency(
+				"[LockFreeQueue]", 1, 1, ITEMS_PER_PRODUCER, 1,
+				[&](const uint64_t* values, size_t) { lockFreeQueue.enqueue(*values); return size_t(1); },
+				[&](uint64_t* out, size_t) { return size_t(lockFreeQueue.dequeue(*out) ? 1 : 0); });
+		}
+		for (const size_t batchSize : { size_t(1), BATCH_SIZE })
+		{
+			SPSCRingBuffer<uint64_t> spscRing(RING_CAPACITY);
+			benchmarkHandOffLatency(
+				"[SPSCRingBuffer]", 1, 1, ITEMS_PER_PRODUCER, batchSize,
+				[&](const uint64_t* values, const size_t count) { return spscRing.try_push_n(values, count); },
+				[&](uint64_t* out, const size_t maxCount) { return spscRing.try_pop_n(out, maxCount); });
+		}
+
+		const size_t maxThreads = std::max<size_t>(4, std::thread::hardware_concurrency());
+		for (size_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+		{
+			for (const size_t batchSize : { size_t(1), BATCH_SIZE })
+			{
+				MPMCRingBuffer<uint64_t> mpmcRing(RING_CAPACITY);
+				benchmarkHandOffLatency(
+					"[MPMCRingBuffer]", threadCount, threadCount, ITEMS_PER_PRODUCER / threadCount, batchSize,
+					[&](const uint64_t* values, const size_t count) { return mpmcRing.try_push_n(values, count); },
+					[&](uint64_t* out, const size_t maxCount) { return mpmcRing.try_pop_n(out, maxCount); });
+			}
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingLinkedListSortWithBenchmark()
+{
+	// Constants
+	static constexpr size_t MAX_ELEMENTS = 10000000;
+
+	try
+	{
+		// every list gets a fresh pool, so each run starts from nodes laid out in list order
+		// instead of whatever order the previous run left the heap in
+		using List = LinkedList<uint64_t, PoolAllocator<uint64_t>>;
+
+		std::mt19937_64 generator(42);
+		const auto fillList = [&](List& list, const size_t count) {
+			generator.seed(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				list.insertAtTail(generator());
+			}
+		};
+
+		for (size_t count = 100000; count <= MAX_ELEMENTS; count *= 10)
+		{
+			// What callers do today: copy into a vector, sort that and write the values back
+			{
+				List list;
+				fillList(list, count);
+				std::cout << "[Copy to vector + std::sort] " << count << " elements: ";
+				Timer timer;
+				std::vector<uint64_t> values(list.begin(), list.end());
+				std::sort(values.begin(), values.end());
+				std::copy(values.begin(), values.end(), list.begin());
+			}
+			{
+				List list;
+				fillList(list, count);
+				std::cout << "[LinkedList::sort] " << count << " elements: ";
+				{
+					Timer timer;
+					list.sort();
+				}
+				if (!std::is_sorted(list.cbegin(), list.cend()))
+				{
+					std::cout << "LinkedList::sort left the list unsorted!" << std::endl;
+					return -1;
+				}
+			}
+			{
+				List list;
+				fillList(list, count);
+				std::cout << "[LinkedList::parallelSort] " << count << " elements, " << std::max(1u, std::thread::hardware_concurrency()) << " threads: ";
+				{
+					Timer timer;
+					list.parallelSort();
+				}
+				if (!std::is_sorted(list.cbegin(), list.cend()))
+				{
+					std::cout << "LinkedList::parallelSort left the list unsorted!" << std::endl;
+					return -1;
+				}
+			}
+		}
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingBinarySearchTreeFindWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 1000000;
+	static constexpr size_t DFS_LOOKUPS = 200; // every DFS visits up to the whole tree
+	static constexpr size_t FIND_LOOKUPS = 1000000;
+
+	try
+	{
+		std::mt19937 generator(7);
+		std::vector<int> keys(KEY_COUNT);
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			keys[i] = static_cast<int>(2 * i); // only even keys, odd ones are misses
+		}
+		std::shuffle(keys.begin(), keys.end(), generator);
+
+		BinarySearchTree<int> bst;
+		for (const int key : keys)
+		{
+			bst.insertNode(key);
+		}
+
+		std::uniform_int_distribution<int> lookupDistribution(0, static_cast<int>(2 * KEY_COUNT));
+		std::vector<int> lookups(FIND_LOOKUPS);
+		for (int& lookup : lookups)
+		{
+			lookup = lookupDistribution(generator);
+		}
+
+		size_t dfsHits = 0;
+		std::chrono::duration<double, std::nano> dfsTook;
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (size_t i = 0; i < DFS_LOOKUPS; ++i)
+			{
+				dfsHits += bst.DFS(lookups[i]) != nullptr ? 1 : 0;
+			}
+			dfsTook = std::chrono::high_resolution_clock::now() - start;
+		}
+
+		size_t findHits = 0;
+		size_t dfsAgreement = 0;
+		std::chrono::duration<double, std::nano> findTook;
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (const int lookup : lookups)
+			{
+				findHits += bst.find(lookup) != nullptr ? 1 : 0;
+			}
+			findTook = std::chrono::high_resolution_clock::now() - start;
+		}
+		for (size_t i = 0; i < DFS_LOOKUPS; ++i)
+		{
+			dfsAgreement += bst.find(lookups[i]) != nullptr ? 1 : 0;
+		}
+
+		std::cout << "[BinarySearchTree::DFS] " << KEY_COUNT << " keys: " << dfsTook.count() / DFS_LOOKUPS << " ns per lookup" << std::endl;
+		std::cout << "[BinarySearchTree::find] " << KEY_COUNT << " keys: " << findTook.count() / FIND_LOOKUPS << " ns per lookup" << std::endl;
+
+		// range queries: walk the keys in [from, to) by repeated upper_bound
+		size_t inRange = 0;
+		std::cout << "[BinarySearchTree::lower_bound/upper_bound] 1000 range scans of 100 keys: ";
+		{
+			Timer timer;
+			for (size_t i = 0; i < 1000; ++i)
+			{
+				const int from = lookups[i];
+				for (BinarySearchTreeNode<int>* node = bst.lower_bound(from); node != nullptr && node->getData() < from + 200; node = bst.upper_bound(node->getData()))
+				{
+					++inRange;
+				}
+			}
+		}
+
+		std::cout << "DFS hits: " << dfsHits << " (find agrees: " << (dfsHits == dfsAgreement) << ")\tfind hits: " << findHits
+			<< "\tKeys in ranges: " << inRange << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingAVLTreeOrderStatisticsWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 1000000;
+	static constexpr size_t WALK_QUERIES = 100; // every walk visits up to the whole tree
+	static constexpr size_t QUERIES = 1000000;
+
+	using AggregateTree = AVLTree<int, std::less<>, std::allocator<int>, AVLRangeAggregate<SumMonoid<long long>>>;
+
+	try
+	{
+		std::mt19937 generator(11);
+		std::vector<int> keys(KEY_COUNT);
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			keys[i] = static_cast<int>(2 * i);
+		}
+		std::shuffle(keys.begin(), keys.end(), generator);
+
+		// the price of keeping sizes and sums up to date
+		{
+			AVLTree<int> plain;
+			std::cout << "[AVLTree] insert " << KEY_COUNT << " keys: ";
+			Timer timer;
+			for (const int key : keys)
+			{
+				plain.insertNode(key);
+			}
+		}
+
+		AggregateTree avl;
+		{
+			std::cout << "[AVLTree AVLRangeAggregate] insert " << KEY_COUNT << " keys: ";
+			Timer timer;
+			for (const int key : keys)
+			{
+				avl.insertNode(key);
+			}
+		}
+
+		std::uniform_int_distribution<int> keyDistribution(0, static_cast<int>(2 * KEY_COUNT));
+		std::vector<std::pair<int, int>> ranges(QUERIES);
+		for (auto &range : ranges)
+		{
+			range.first = keyDistribution(generator);
+			range.second = range.first + keyDistribution(generator) / 4;
+		}
+
+		// without augmentation: walk in order up to the k-th key / the end of the range
+		const auto walkInOrder = [&avl](const auto &visit)
+		{
+			std::vector<AggregateTree::NodeType *> pending;
+			AggregateTree::NodeType *currNode = avl.getRoot();
+			while (currNode != nullptr || !pending.empty())
+			{
+				for (; currNode != nullptr; currNode = currNode->getLeft())
+				{
+					pending.push_back(currNode);
+				}
+				currNode = pending.back();
+				pending.pop_back();
+				if (!visit(currNode->getData()))
+				{
+					return;
+				}
+				currNode = currNode->getRight();
+			}
+		};
+
+		long long walkChecksum = 0;
+		long long walkAgreement = 0;
+		std::chrono::duration<double, std::nano> walkTook;
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (size_t i = 0; i < WALK_QUERIES; ++i)
+			{
+				size_t position = 0;
+				walkInOrder([&](const int key) { if (position++ == static_cast<size_t>(ranges[i].first) / 2) { walkChecksum += key; return false; } return true; });
+
+				long long sum = 0;
+				walkInOrder([&](const int key) { if (key > ranges[i].second) return false; if (key >= ranges[i].first) sum += key; return true; });
+				walkChecksum += sum;
+			}
+			walkTook = std::chrono::high_resolution_clock::now() - start;
+		}
+		for (size_t i = 0; i < WALK_QUERIES; ++i)
+		{
+			walkAgreement += avl.select(static_cast<size_t>(ranges[i].first) / 2)->getData();
+			walkAgreement += avl.aggregate(ranges[i].first, ranges[i].second);
+		}
+
+		long long checksum = 0;
+		std::chrono::duration<double, std::nano> selectTook, rankTook, aggregateTook;
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (const auto &range : ranges)
+			{
+				checksum += avl.select(static_cast<size_t>(range.first) / 2)->getData();
+			}
+			selectTook = std::chrono::high_resolution_clock::now() - start;
+		}
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (const auto &range : ranges)
+			{
+				checksum += static_cast<long long>(avl.rank(range.first));
+			}
+			rankTook = std::chrono::high_resolution_clock::now() - start;
+		}
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			for (const auto &range : ranges)
+			{
+				checksum += avl.aggregate(range.first, range.second);
+			}
+			aggregateTook = std::chrono::high_resolution_clock::now() - start;
+		}
+
+		std::cout << "[in-order walk] select + range sum: " << walkTook.count() / WALK_QUERIES << " ns per query pair" << std::endl;
+		std::cout << "[AVLTree::select] " << selectTook.count() / QUERIES << " ns per query" << std::endl;
+		std::cout << "[AVLTree::rank] " << rankTook.count() / QUERIES << " ns per query" << std::endl;
+		std::cout << "[AVLTree::aggregate] " << aggregateTook.count() / QUERIES << " ns per query" << std::endl;
+
+		// removals keep the augmentation correct as well
+		{
+			std::cout << "[AVLTree AVLRangeAggregate] remove " << KEY_COUNT / 2 << " keys: ";
+			Timer timer;
+			for (size_t i = 0; i < KEY_COUNT / 2; ++i)
+			{
+				avl.removeNode(keys[i]);
+			}
+		}
+
+		long long expectedSum = 0;
+		for (size_t i = KEY_COUNT / 2; i < KEY_COUNT; ++i)
+		{
+			expectedSum += keys[i];
+		}
+
+		std::cout << "Walk agrees: " << (walkChecksum == walkAgreement) << "\tChecksum: " << checksum
+			<< "\tSize after removal: " << avl.getSize() << "\tSum agrees: " << (avl.aggregate(0, static_cast<int>(2 * KEY_COUNT)) == expectedSum) << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingTreeIteratorsWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 2000000;
+	static constexpr size_t RANGE_SCANS = 1000;
+	static constexpr int RANGE_WIDTH = 2000; // keys are even, so about 1000 values per scan
+
+	try
+	{
+		std::mt19937 generator(13);
+		std::vector<int> keys(KEY_COUNT);
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			keys[i] = static_cast<int>(2 * i);
+		}
+		std::shuffle(keys.begin(), keys.end(), generator);
+
+		AVLTree<int> avl;
+		BinarySearchTree<int> bst;
+		for (const int key : keys)
+		{
+			avl.insertNode(key);
+			bst.insertNode(key);
+		}
+
+		// what a scan had to do before: recurse over the tree and copy into a vector
+		std::function<void(AVLNode<int> *, std::vector<int> &)> collectInOrder = [&collectInOrder](AVLNode<int> *node, std::vector<int> &out)
+		{
+			if (node != nullptr)
+			{
+				collectInOrder(node->getLeft(), out);
+				out.push_back(node->getData());
+				collectInOrder(node->getRight(), out);
+			}
+		};
+
+		long long copySum = 0;
+		{
+			std::cout << "[AVLTree] full scan, recursive copy into a vector: ";
+			Timer timer;
+			std::vector<int> copied;
+			collectInOrder(avl.getRoot(), copied);
+			for (const int value : copied)
+			{
+				copySum += value;
+			}
+		}
+
+		long long avlSum = 0;
+		{
+			std::cout << "[AVLTree] full scan, iterator: ";
+			Timer timer;
+			for (const int value : avl)
+			{
+				avlSum += value;
+			}
+		}
+
+		long long bstSum = 0;
+		{
+			std::cout << "[BinarySearchTree] full scan, iterator: ";
+			Timer timer;
+			for (const int value : bst)
+			{
+				bstSum += value;
+			}
+		}
+
+		long long reverseSum = 0;
+		{
+			std::cout << "[AVLTree] full scan backwards, iterator: ";
+			Timer timer;
+			for (auto it = avl.end(); it != avl.begin();)
+			{
+				reverseSum += *--it;
+			}
+		}
+
+		std::uniform_int_distribution<int> keyDistribution(0, static_cast<int>(2 * KEY_COUNT));
+		std::vector<int> rangeStarts(RANGE_SCANS);
+		for (int &start : rangeStarts)
+		{
+			start = keyDistribution(generator);
+		}
+
+		long long avlRangeSum = 0;
+		{
+			std::cout << "[AVLTree] " << RANGE_SCANS << " range scans: ";
+			Timer timer;
+			for (const int start : rangeStarts)
+			{
+				for (const int value : avl.range(start, start + RANGE_WIDTH))
+				{
+					avlRangeSum += value;
+				}
+			}
+		}
+
+		long long bstRangeSum = 0;
+		{
+			std::cout << "[BinarySearchTree] " << RANGE_SCANS << " range scans: ";
+			Timer timer;
+			for (const int start : rangeStarts)
+			{
+				for (const int value : bst.range(start, start + RANGE_WIDTH))
+				{
+					bstRangeSum += value;
+				}
+			}
+		}
+
+		std::cout << "Full scans agree: " << (copySum == avlSum && avlSum == bstSum && bstSum == reverseSum)
+			<< "\tRange scans agree: " << (avlRangeSum == bstRangeSum) << "\tRange sum: " << avlRangeSum << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingBuildFromSortedWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 10000000;
+	static constexpr size_t LIST_SHAPED_COUNT = 20000; // sorted insertNode into a BinarySearchTree is O(n^2)
+
+	try
+	{
+		std::vector<int> keys(KEY_COUNT);
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			keys[i] = static_cast<int>(2 * i);
+		}
+
+		const auto scan = [](auto &tree) {
+			long long sum = 0;
+			std::cout << "\tfull scan: ";
+			Timer timer;
+			for (const int value : tree)
+			{
+				sum += value;
+			}
+			return sum;
+		};
+
+		long long insertedSum = 0;
+		{
+			AVLTree<int> avl;
+			{
+				std::cout << "[AVLTree] insertNode " << KEY_COUNT << " sorted keys: ";
+				Timer timer;
+				for (const int key : keys)
+				{
+					avl.insertNode(key);
+				}
+			}
+			insertedSum = scan(avl);
+		}
+
+		long long builtSum = 0;
+		{
+			AVLTree<int> avl;
+			{
+				std::cout << "[AVLTree] build_from_sorted " << KEY_COUNT << " keys: ";
+				Timer timer;
+				avl.build_from_sorted(keys.begin(), keys.end());
+			}
+			builtSum = scan(avl);
+		}
+
+		long long parallelBuiltSum = 0;
+		{
+			AVLTree<int> avl;
+			{
+				std::cout << "[AVLTree] parallel_build_from_sorted " << KEY_COUNT << " keys, " << std::thread::hardware_concurrency() << " threads: ";
+				Timer timer;
+				avl.parallel_build_from_sorted(keys.begin(), keys.end());
+			}
+			parallelBuiltSum = scan(avl);
+		}
+
+		{
+			BinarySearchTree<int> bst;
+			std::cout << "[BinarySearchTree] insertNode " << LIST_SHAPED_COUNT << " sorted keys: ";
+			Timer timer;
+			for (size_t i = 0; i < LIST_SHAPED_COUNT; ++i)
+			{
+				bst.insertNode(keys[i]);
+			}
+		}
+
+		size_t bstHits = 0;
+		{
+			BinarySearchTree<int> bst;
+			{
+				std::cout << "[BinarySearchTree] build_from_sorted " << KEY_COUNT << " keys: ";
+				Timer timer;
+				bst.build_from_sorted(keys.begin(), keys.end());
+			}
+			std::cout << "\t" << KEY_COUNT << " finds: ";
+			Timer timer;
+			for (const int key : keys)
+			{
+				bstHits += bst.find(key) != nullptr ? 1 : 0;
+			}
+		}
+
+		std::cout << "Scans agree: " << (insertedSum == builtSum && builtSum == parallelBuiltSum) << "\tBinarySearchTree hits: " << bstHits << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
+int testingAVLTreeSetOperationsWithBenchmark()
+{
+	// Constants
+	static constexpr size_t KEY_COUNT = 10000000;
+	static constexpr size_t SMALL_COUNT = 1000;
+
+	try
+	{
+		// evens and multiples of 3, a third of the values of each tree are in the other one as well
+		std::vector<int> evens(KEY_COUNT);
+		std::vector<int> triples(KEY_COUNT);
+		for (size_t i = 0; i < KEY_COUNT; ++i)
+		{
+			evens[i] = static_cast<int>(2 * i);
+			triples[i] = static_cast<int>(3 * i);
+		}
+		const std::vector<int> smallSet(triples.begin(), triples.begin() + SMALL_COUNT);
+
+		std::vector<int> common;
+		std::set_intersection(evens.begin(), evens.end(), triples.begin(), triples.end(), std::back_inserter(common));
+		const size_t unionSize = 2 * KEY_COUNT - common.size();
+
+		const auto countValues = [](AVLTree<int> &tree) {
+			return static_cast<size_t>(std::distance(tree.begin(), tree.end()));
+		};
+
+		bool sizesAgree = true;
+		{
+			AVLTree<int> avl;
+			avl.build_from_sorted(evens.begin(), evens.end());
+			{
+				std::cout << "[AVLTree] union by insertNode of " << KEY_COUNT << " keys: ";
+				Timer timer;
+				for (const int key : triples)
+				{
+					avl.insertNode(key);
+				}
+			}
+			sizesAgree = sizesAgree && countValues(avl) == unionSize;
+		}
+
+		{
+			AVLTree<int> avl;
+			avl.build_from_sorted(evens.begin(), evens.end());
+			{
+				std::cout << "[AVLTree] difference by removeNode of " << KEY_COUNT << " keys: ";
+				Timer timer;
+				for (const int key : triples)
+				{
+					avl.removeNode(key);
+				}
+			}
+			sizesAgree = sizesAgree && countValues(avl) == KEY_COUNT - common.size();
+		}
+
+		// scaling across threads; with fewer cores than threads the forks only add overhead
+		std::cout << "hardware_concurrency: " << std::thread::hardware_concurrency() << std::endl;
+		for (size_t threads = 1; threads <= 8; threads *= 2)
+		{
+			for (int operation = 0; operation < 3; ++operation)
+			{
+				AVLTree<int> mine;
+				AVLTree<int> theirs;
+				mine.build_from_sorted(evens.begin(), evens.end());
+				theirs.build_from_sorted(triples.begin(), triples.end());
+
+				size_t expectedSize = 0;
+				{
+					Timer timer;
+					if (operation == 0)
+					{
+						std::cout << "[AVLTree] unionWith, " << threads << " threads: ";
+						mine.unionWith(theirs, threads);
+						expectedSize = unionSize;
+					}
+					else if (operation == 1)
+					{
+						std::cout << "[AVLTree] intersectionWith, " << threads << " threads: ";
+						mine.intersectionWith(theirs, threads);
+						expectedSize = common.size();
+					}
+					else
+					{
+						std::cout << "[AVLTree] differenceWith, " << threads << " threads: ";
+						mine.differenceWith(theirs, threads);
+						expectedSize = KEY_COUNT - common.size();
+					}
+				}
+				sizesAgree = sizesAgree && countValues(mine) == expectedSize && theirs.getRoot() == nullptr;
+			}
+		}
+
+		// a small tree against a large one: O(m log(n / m + 1)) is close to m insertions
+		{
+			AVLTree<int> avl;
+			avl.build_from_sorted(evens.begin(), evens.end());
+			std::cout << "[AVLTree] union by insertNode of " << SMALL_COUNT << " keys: ";
+			Timer timer;
+			for (const int key : smallSet)
+			{
+				avl.insertNode(key);
+			}
+		}
+		{
+			AVLTree<int> mine;
+			AVLTree<int> theirs;
+			mine.build_from_sorted(evens.begin(), evens.end());
+			theirs.build_from_sorted(smallSet.begin(), smallSet.end());
+			std::cout << "[AVLTree] unionWith a tree of " << SMALL_COUNT << " keys: ";
+			Timer timer;
+			mine.unionWith(theirs);
+		}
+
+		// split in the middle and join again
+		{
+			AVLTree<int> lower;
+			AVLTree<int> upper;
+			lower.build_from_sorted(evens.begin(), evens.end());
+			const int middle = evens[KEY_COUNT / 2];
+			{
+				std::cout << "[AVLTree] split and join at " << middle << ": ";
+				Timer timer;
+				lower.split(middle, upper);
+				lower.join(middle, upper);
+			}
+			sizesAgree = sizesAgree && countValues(lower) == KEY_COUNT;
+		}
+
+		std::cout << "Sizes agree: " << sizesAgree << std::endl;
+
+		return 0;
+	}
+	catch (const std::exception &)
+	{
+		return -1;
+	}
+}
+
 int testingBinarySearchTree()
 {
 	try
@@ -364,6 +2531,29 @@ int testAVLTreeDeletionCases()
 int main(int argc, char *argv[])
 {
 	// return testingHashTableWithBenchmark();
+	// return testingFlatHashTableWithBenchmark();
+	// return testingFlatHashTableBatchWithBenchmark();
+	// return testingConcurrentHashTableWithBenchmark();
+	// return testingLockFreeHashTableWithBenchmark();
+	// return testingHashPoliciesWithBenchmark();
+	// return testingTransparentLookupWithBenchmark();
+	// return testingStringHashTableWithBenchmark();
+	// return testingBoundedCacheWithBenchmark();
+	// return testingMappedHashTableWithBenchmark();
+	// return testingBlockedBloomFilterWithBenchmark();
+	// return testingEraseIfWithBenchmark();
+	// return testingPoolAllocatorWithBenchmark();
+	// return testingUnrolledLinkedListWithBenchmark();
+	// return testingLinkedListQueueWithBenchmark();
+	// return testingLinkedListIteratorsWithBenchmark();
+	// return testingLockFreeQueueWithBenchmark();
+	// return testingRingBufferWithBenchmark();
+	// return testingLinkedListSortWithBenchmark();
+	// return testingBinarySearchTreeFindWithBenchmark();
+	// return testingAVLTreeOrderStatisticsWithBenchmark();
+	// return testingTreeIteratorsWithBenchmark();
+	// return testingBuildFromSortedWithBenchmark();
+	// return testingAVLTreeSetOperationsWithBenchmark();
 	// return testingBinarySearchTree();
 	return testAVLTreeDeletionCases();
 }
\ No newline at end of file